@@ -0,0 +1,135 @@
+#include "PerfOverlay.h"
+#include "Renderer2D.h"
+#include <Gizmos.h>
+#include <imgui.h>
+#include <chrono>
+#include <cstdio>
+
+typedef std::chrono::high_resolution_clock Clock;
+
+void PerfOverlay::record(const float deltaTime, const RenderState::Stats& stats, const aie::Renderer2D& renderer)
+{
+	Clock::time_point start = Clock::now();
+
+	// the phases are only from the last step, an update without one has none
+	int substeps = stats.updateStepCount;
+	PhysicsScene::StepTimings timings = {};
+	if (substeps > 0)
+	{
+		timings = stats.stepTimings;
+	}
+
+	float values[GRAPH_COUNT];
+	values[FRAME_TIME] = deltaTime * 1000.0f;
+	values[SUBSTEPS] = (float)substeps;
+	values[INTEGRATE] = (float)timings.integrate;
+	values[PAIRS] = (float)timings.pairs;
+	values[NARROWPHASE] = (float)timings.narrowphase;
+	values[RESPONSE] = (float)timings.response;
+	values[SLEEPING] = (float)timings.sleeping;
+	values[BODIES] = (float)stats.actorCount;
+	values[PAIR_COUNT] = (float)stats.pairCount;
+	values[CONTACTS] = (float)stats.contactCount;
+	values[GIZMO_LINES] = (float)aie::Gizmos::get2DLineCount();
+	values[GIZMO_TRIS] = (float)aie::Gizmos::get2DTriCount();
+	values[SPRITE_VERTICES] = (float)renderer.getPeakBatchVertices();
+
+	for (int i = 0; i < GRAPH_COUNT; i++)
+	{
+		m_history[i][m_next] = values[i];
+	}
+	m_next = (m_next + 1) % HISTORY_SIZE;
+
+	m_gizmoLineCapacity = (float)aie::Gizmos::getMax2DLines();
+	m_gizmoTriCapacity = (float)aie::Gizmos::getMax2DTris();
+	m_spriteVertexCapacity = (float)renderer.getMaxBatchVertices();
+	m_maxSubsteps = stats.maxSubsteps;
+	m_droppedSteps = stats.droppedStepCount;
+	m_governor = stats.governor;
+	m_timeStep = stats.timeStep;
+	m_solverIterations = stats.solverIterations;
+
+	m_recordMilliseconds = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void PerfOverlay::draw()
+{
+	Clock::time_point start = Clock::now();
+
+	ImGui::SetNextWindowSize(ImVec2(420, 0), ImGuiSetCond_FirstUseEver);
+	ImGui::Begin("Performance");
+	ImGui::Text("overlay %.3f ms to record, %.3f ms to draw", m_recordMilliseconds, m_drawMilliseconds);
+
+	plot(FRAME_TIME, "frame", "%.2f ms");
+	plot(SUBSTEPS, "substeps", "%.0f", (float)m_maxSubsteps);
+	ImGui::Text("%d steps dropped for going over %d substeps", m_droppedSteps, m_maxSubsteps);
+
+	ImGui::Separator();
+	if (m_governor.budget > 0.0)
+	{
+		ImGui::Text("governor level %d of %d, %.2f ms of %.2f ms budget", m_governor.level, FrameGovernor::LEVEL_COUNT - 1,
+			m_governor.cost, m_governor.budget);
+		ImGui::Text("%d updates over budget, %d level changes", m_governor.overBudgetUpdates, m_governor.levelChanges);
+	}
+	else
+	{
+		ImGui::Text("governor off");
+	}
+	ImGui::Text("time step %.2f ms, %d solver iterations", m_timeStep * 1000.0f, m_solverIterations);
+
+	ImGui::Separator();
+	ImGui::Text("last physics step");
+	plot(INTEGRATE, "integrate", "%.3f ms");
+	plot(PAIRS, "pairs", "%.3f ms");
+	plot(NARROWPHASE, "narrowphase", "%.3f ms");
+	plot(RESPONSE, "response", "%.3f ms");
+	plot(SLEEPING, "sleeping", "%.3f ms");
+
+	ImGui::Separator();
+	plot(BODIES, "bodies", "%.0f");
+	plot(PAIR_COUNT, "pairs", "%.0f");
+	plot(CONTACTS, "contacts", "%.0f");
+
+	ImGui::Separator();
+	ImGui::Text("buffer usage");
+	plotUsage(GIZMO_LINES, "gizmo lines", m_gizmoLineCapacity);
+	plotUsage(GIZMO_TRIS, "gizmo tris", m_gizmoTriCapacity);
+	plotUsage(SPRITE_VERTICES, "sprite batch", m_spriteVertexCapacity);
+
+	ImGui::End();
+
+	m_drawMilliseconds = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void PerfOverlay::plot(const Graph graph, const char* label, const char* format, const float max)
+{
+	const float* history = m_history[graph];
+	float latest = history[(m_next + HISTORY_SIZE - 1) % HISTORY_SIZE];
+
+	// scale to the largest value in the history unless told otherwise
+	float scaleMax = max;
+	if (scaleMax <= 0.0f)
+	{
+		for (int i = 0; i < HISTORY_SIZE; i++)
+		{
+			scaleMax = history[i] > scaleMax ? history[i] : scaleMax;
+		}
+	}
+
+	char text[64];
+	snprintf(text, sizeof(text), format, latest);
+
+	// the label is also the id, the same label can be used by two graphs
+	ImGui::PushID(graph);
+	ImGui::PlotLines(label, history, HISTORY_SIZE, m_next, text, 0.0f, scaleMax > 0.0f ? scaleMax : 1.0f, ImVec2(0, 40));
+	ImGui::PopID();
+}
+
+void PerfOverlay::plotUsage(const Graph graph, const char* label, const float capacity)
+{
+	float latest = m_history[graph][(m_next + HISTORY_SIZE - 1) % HISTORY_SIZE];
+
+	char format[64];
+	snprintf(format, sizeof(format), "%%.0f / %.0f (%.0f%%%%)", capacity, capacity > 0.0f ? latest / capacity * 100.0f : 0.0f);
+	plot(graph, label, format, capacity);
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include "RenderState.h"
+
+namespace aie
+{
+	class Renderer2D;
+}
+
+// an imgui window with rolling graphs of the frame time, the physics
+// phases and counts, and how full the gizmo and sprite buffers are.
+// recording a frame only copies a few numbers into the history, so it
+// can stay on
+class PerfOverlay
+{
+public:
+	// the frames each graph keeps
+	static constexpr int HISTORY_SIZE = 240;
+
+	// adds a frame to the history. the physics stats are from the last
+	// state published and the renderer's from the last time it drew
+	void record(const float deltaTime, const RenderState::Stats& stats, const aie::Renderer2D& renderer);
+
+	void draw();
+
+private:
+	enum Graph
+	{
+		FRAME_TIME = 0,
+		SUBSTEPS,
+		INTEGRATE,
+		PAIRS,
+		NARROWPHASE,
+		RESPONSE,
+		SLEEPING,
+		BODIES,
+		PAIR_COUNT,
+		CONTACTS,
+		GIZMO_LINES,
+		GIZMO_TRIS,
+		SPRITE_VERTICES,
+		GRAPH_COUNT
+	};
+
+	void plot(const Graph graph, const char* label, const char* format, const float max = 0.0f);
+	void plotUsage(const Graph graph, const char* label, const float capacity);
+
+	float m_history[GRAPH_COUNT][HISTORY_SIZE] = {};
+	int m_next = 0;
+
+	float m_gizmoLineCapacity = 0.0f;
+	float m_gizmoTriCapacity = 0.0f;
+	float m_spriteVertexCapacity = 0.0f;
+	int m_maxSubsteps = 0;
+	int m_droppedSteps = 0;
+
+	FrameGovernor::Stats m_governor = {};
+	float m_timeStep = 0.0f;
+	int m_solverIterations = 0;
+
+	// what recording and drawing the overlay cost last frame
+	double m_recordMilliseconds = 0.0;
+	double m_drawMilliseconds = 0.0;
+};
@@ -9,7 +9,13 @@
 #include "Plane.h"
 #include "Box.h"
 #include "Aabb.h"
+#include "SpatialHash.h"
+#include "PhysicsGizmos.h"
+#include "Profiler.h"
+#include <imgui.h>
 #include <random>
+#include <thread>
+#include <algorithm>
 
 #define _USE_MATH_DEFINES
 #include <math.h>
@@ -35,13 +41,21 @@ bool PhysicsApp::startup()
 	m_physicsScene = new PhysicsScene();
 	m_physicsScene->setGravity(glm::vec2(0, -100));
 	m_physicsScene->setTimeStep(0.01f);
+	m_physicsScene->setBroadphase(new SpatialHash(64.0f));
 
-	Plane* plane1 = new Plane();
+	// a 60hz frame runs about two steps, leave at least half of it for
+	// everything else
+	m_physicsScene->setStepBudget(4.0);
+
+	// the render thread keeps a core to itself
+	m_physicsScene->setThreadCount(std::max(1, (int)std::thread::hardware_concurrency() - 1));
+
+	Plane* plane1 = m_physicsScene->create<Plane>();
 	plane1->setNormal(1, 2);
 	plane1->setDistance(300);
 	m_physicsScene->addActor(plane1);
 
-	Plane* plane2 = new Plane();
+	Plane* plane2 = m_physicsScene->create<Plane>();
 	plane2->setNormal(1, -2);
 	plane2->setDistance(300);
 	m_physicsScene->addActor(plane2);
@@ -50,7 +64,7 @@ bool PhysicsApp::startup()
 
 	for (int i = 0; i < numBoxes; i++)
 	{
-		Box* box = new Box();
+		Box* box = m_physicsScene->create<Box>();
 
 		float theta = glm::radians(i * 360.0f / (float)numBoxes);
 
@@ -71,21 +85,60 @@ bool PhysicsApp::startup()
 		m_physicsScene->addActor(box);
 	}
 
+	// from here on the scene belongs to the physics thread
+	m_physicsThread = new PhysicsThread(m_physicsScene);
+	m_physicsThread->start();
+
 	return true;
 }
 
 void PhysicsApp::shutdown()
 {
+	setAllocationTracking(false);
+	m_physicsThread->stop();
+	delete m_physicsThread;
+	delete m_physicsScene;
 	delete m_font;
 	delete m_2dRenderer;
 }
 
 void PhysicsApp::update(float deltaTime)
 {
+	// the bootstrap loop between the last draw and now was the framework
+	AllocationCounter::setTag(AllocationCounter::OTHER);
+	if (m_trackingAllocations)
+	{
+		AllocationCounter::Snapshot now = AllocationCounter::getSnapshot();
+		m_lastFrame = now.since(m_frameStart);
+		m_frameStart = now;
+		AllocationCounter::writeCsv(m_allocationLog, "frame", m_frame, m_lastFrame);
+	}
+	m_frame++;
+
+	// a frame runs from one update to the next
+	Profiler::endFrame();
+	PROFILE_ZONE("PhysicsApp::update");
+
 	// input example
 	aie::Input* input = aie::Input::getInstance();
 
-	aie::Gizmos::clear();
+	if (input->wasKeyPressed(aie::INPUT_KEY_F1))
+	{
+		setAllocationTracking(!m_trackingAllocations);
+	}
+	if (input->wasKeyPressed(aie::INPUT_KEY_F2))
+	{
+		setProfiling(!m_profiling);
+	}
+	if (input->wasKeyPressed(aie::INPUT_KEY_F3))
+	{
+		m_showPerfOverlay = !m_showPerfOverlay;
+	}
+
+	{
+		AllocationCounter::ScopedTag tag(AllocationCounter::GIZMOS);
+		aie::Gizmos::clear();
+	}
 
 	glm::vec2 mousePos = glm::vec2(input->getMouseX(), input->getMouseY());
 
@@ -93,18 +146,37 @@ void PhysicsApp::update(float deltaTime)
 	{
 		glm::vec4 randomColor(rand() % 256 / 255.0f, rand() % 256 / 255.0f, rand() % 256 / 255.0f, 1.0f);
 
-		Sphere* ball = new Sphere();
-		ball->setPosition(mousePos);
-		ball->setMass(1);
-		ball->setRadius(20);
-		ball->setElasticity(0.3f);
-		ball->setColor(randomColor);
-		ball->calculateMoment();
-		m_physicsScene->addActor(ball);
+		m_physicsThread->post([mousePos, randomColor](PhysicsScene& scene)
+		{
+			Sphere* ball = scene.create<Sphere>();
+			ball->setPosition(mousePos);
+			ball->setMass(1);
+			ball->setRadius(20);
+			ball->setElasticity(0.3f);
+			ball->setColor(randomColor);
+			ball->calculateMoment();
+			scene.addActor(ball);
+		});
 	}
 
-	m_physicsScene->update(deltaTime);
-	m_physicsScene->draw();
+	// the physics steps on its own thread, this draws the newest state it
+	// has published
+	const RenderState& state = m_physicsThread->acquire();
+
+	{
+		AllocationCounter::ScopedTag tag(AllocationCounter::GIZMOS);
+		PhysicsGizmos::draw(state, m_physicsThread->getInterpolationAlpha());
+	}
+
+	if (m_trackingAllocations)
+	{
+		drawAllocationOverlay(state.stats.stepAllocations);
+	}
+	if (m_showPerfOverlay)
+	{
+		m_perfOverlay.record(deltaTime, state.stats, *m_2dRenderer);
+		m_perfOverlay.draw();
+	}
 
 	// exit the application
 	if (input->isKeyDown(aie::INPUT_KEY_ESCAPE))
@@ -113,26 +185,137 @@ void PhysicsApp::update(float deltaTime)
 	}
 	if (input->isKeyDown(aie::INPUT_KEY_SPACE))
 	{
-		m_physicsScene->setGravity(glm::vec2(0, -9.81f));
+		m_physicsThread->post([](PhysicsScene& scene) { scene.setGravity(glm::vec2(0, -9.81f)); });
 	}
 }
 
 void PhysicsApp::draw()
 {
+	PROFILE_ZONE("PhysicsApp::draw");
+
 	// wipe the screen to the background colour
 	clearScreen();
 	//glClear(GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
 
 	// begin drawing sprites
+	AllocationCounter::setTag(AllocationCounter::RENDERER);
 	m_2dRenderer->begin();
 
 	float aspectRatio = 16 / 9.f;
+	AllocationCounter::setTag(AllocationCounter::GIZMOS);
 	aie::Gizmos::draw2D(glm::ortho<float>(0, (float)getWindowWidth(), 0, (float)getWindowHeight(), -1.0f, 1.0f));
 
 	// output some text, uses the last used colour
+	AllocationCounter::setTag(AllocationCounter::RENDERER);
 	m_2dRenderer->drawText(m_font, "Press ESC to quit", 0, 0);
 
 	// done drawing sprites
 	m_2dRenderer->end();
+
+	// everything until the next update is the bootstrap loop, imgui,
+	// swapping buffers and Input::clearStatus
+	AllocationCounter::setTag(AllocationCounter::FRAMEWORK);
+}
+
+void PhysicsApp::setAllocationTracking(const bool tracking)
+{
+	if (tracking == m_trackingAllocations)
+	{
+		return;
+	}
+
+	m_trackingAllocations = tracking;
+	AllocationCounter::setTracking(tracking);
+
+	if (tracking)
+	{
+		m_allocationLog = fopen("allocations.csv", "w");
+		if (m_allocationLog != nullptr)
+		{
+			AllocationCounter::writeCsvHeader(m_allocationLog);
+		}
+		m_frameStart = AllocationCounter::getSnapshot();
+		m_lastFrame = m_frameStart.since(m_frameStart);
+
+		FILE* log = m_allocationLog;
+		m_physicsThread->post([log](PhysicsScene& scene) { scene.setAllocationLog(log); });
+	}
+	else if (m_allocationLog != nullptr)
+	{
+		// the physics thread might be writing a step, so it closes the log
+		FILE* log = m_allocationLog;
+		m_physicsThread->post([log](PhysicsScene& scene)
+		{
+			scene.setAllocationLog(nullptr);
+			fclose(log);
+		});
+		m_allocationLog = nullptr;
+	}
+}
+
+void PhysicsApp::setProfiling(const bool profiling)
+{
+	if (profiling == m_profiling)
+	{
+		return;
+	}
+
+	m_profiling = profiling;
+
+	// the physics thread records zones all through an update, so starting
+	// and stopping happens between two of them while this thread waits
+	m_physicsThread->postAndWait([profiling](PhysicsScene&)
+	{
+		if (profiling)
+		{
+			Profiler::clear();
+			Profiler::setEnabled(true);
+		}
+		else
+		{
+			Profiler::setEnabled(false);
+			if (!Profiler::writeChromeTrace("profile.json"))
+			{
+				printf("couldn't write profile.json\n");
+			}
+		}
+	});
+}
+
+void PhysicsApp::drawAllocationOverlay(const AllocationCounter::Snapshot& step)
+{
+	ImGui::Begin("Allocations");
+	ImGui::Text("last frame %zu allocations, %zu bytes", m_lastFrame.getTotalAllocations(), m_lastFrame.getTotalBytes());
+	ImGui::Text("last physics step %zu allocations, %zu bytes", step.getTotalAllocations(), step.getTotalBytes());
+
+	ImGui::Columns(5, "allocations");
+	ImGui::Text("tag");
+	ImGui::NextColumn();
+	ImGui::Text("frame");
+	ImGui::NextColumn();
+	ImGui::Text("frame bytes");
+	ImGui::NextColumn();
+	ImGui::Text("step");
+	ImGui::NextColumn();
+	ImGui::Text("step bytes");
+	ImGui::NextColumn();
+	ImGui::Separator();
+
+	for (int i = 0; i < AllocationCounter::TAG_COUNT; i++)
+	{
+		ImGui::Text("%s", AllocationCounter::getTagName((AllocationCounter::Tag)i));
+		ImGui::NextColumn();
+		ImGui::Text("%zu", m_lastFrame.allocations[i]);
+		ImGui::NextColumn();
+		ImGui::Text("%zu", m_lastFrame.bytesAllocated[i]);
+		ImGui::NextColumn();
+		ImGui::Text("%zu", step.allocations[i]);
+		ImGui::NextColumn();
+		ImGui::Text("%zu", step.bytesAllocated[i]);
+		ImGui::NextColumn();
+	}
+
+	ImGui::Columns(1);
+	ImGui::End();
 }
 
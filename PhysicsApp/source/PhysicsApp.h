@@ -3,6 +3,10 @@
 #include "Application.h"
 #include "Renderer2D.h"
 #include "PhysicsScene.h"
+#include "PhysicsThread.h"
+#include "AllocationCounter.h"
+#include "PerfOverlay.h"
+#include <cstdio>
 
 class PhysicsApp : public aie::Application
 {
@@ -19,7 +23,30 @@ public:
 
 protected:
 
+	// F1 turns allocation tracking on and off. while it's on the overlay
+	// shows what each subsystem allocated and every frame and physics step
+	// is logged to allocations.csv
+	void setAllocationTracking(const bool tracking);
+	void drawAllocationOverlay(const AllocationCounter::Snapshot& step);
+
+	// F2 starts a profiler capture, pressing it again writes the capture
+	// to profile.json for chrome://tracing
+	void setProfiling(const bool profiling);
+
 	aie::Renderer2D*	m_2dRenderer;
 	aie::Font*			m_font;
 	PhysicsScene*		m_physicsScene;
+	PhysicsThread*		m_physicsThread;
+
+	bool m_trackingAllocations = false;
+	FILE* m_allocationLog = nullptr;
+	int m_frame = 0;
+	AllocationCounter::Snapshot m_frameStart;
+	AllocationCounter::Snapshot m_lastFrame;
+
+	bool m_profiling = false;
+
+	// F3 shows the performance overlay
+	PerfOverlay m_perfOverlay;
+	bool m_showPerfOverlay = false;
 };
\ No newline at end of file
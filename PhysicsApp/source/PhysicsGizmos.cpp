@@ -0,0 +1,160 @@
+#include "PhysicsGizmos.h"
+#include "PhysicsScene.h"
+#include "RenderState.h"
+#include "Sphere.h"
+#include "Plane.h"
+#include "Box.h"
+#include "Aabb.h"
+#include "Profiler.h"
+#include <Gizmos.h>
+#include <glm\ext.hpp>
+#include <cmath>
+
+static void drawPlane(const glm::vec2 normal, const float distance)
+{
+	float lineSegmentLength = 3000;
+	glm::vec2 centerPoint = normal * distance;
+	// easy to rotate normal through 90 degrees around z
+	glm::vec2 parallel(normal.y, -normal.x);
+	glm::vec4 color(1, 1, 1, 1);
+	glm::vec2 start = centerPoint + (parallel * lineSegmentLength);
+	glm::vec2 end = centerPoint - (parallel * lineSegmentLength);
+	aie::Gizmos::add2DLine(start, end, color);
+}
+
+static void drawSphere(const glm::vec2 position, const float rotation, const float radius, const glm::vec4 color,
+	const bool reducedDetail)
+{
+	// a rougher circle without the spokes is plenty while the physics is
+	// over budget
+	if (reducedDetail)
+	{
+		aie::Gizmos::add2DCircle(position, radius, 6, color);
+		return;
+	}
+
+	aie::Gizmos::add2DCircle(position, radius, 12, color);
+
+	glm::vec4 invColor(1.0f - color.r, 1.0f - color.g, 1.0f - color.b, 1.0f);
+
+	float angles[4];
+	angles[0] = -15;
+	angles[1] = -115;
+	angles[2] = -165;
+	angles[3] = 115;
+
+	glm::vec2 points[4];
+
+	for (int i = 0; i < 4; i++)
+	{
+		float theta = glm::radians(angles[i] + rotation + 90);
+
+		float sn = std::sinf(theta);
+		float cs = std::cosf(theta);
+
+		glm::vec2 point(sn, -cs);
+
+		point *= radius;
+		point += position;
+
+		points[i] = glm::vec2(point);
+	}
+
+	aie::Gizmos::add2DLine(points[0], points[2], invColor);
+	aie::Gizmos::add2DLine(points[1], points[3], invColor);
+}
+
+static void drawAabb(const glm::vec2 position, const glm::vec2 extents, const glm::vec4 color)
+{
+	aie::Gizmos::add2DAABBFilled(position, extents, color);
+}
+
+static void drawBox(const glm::vec2 position, const float rotation, const glm::vec2 extents, const glm::vec4 color)
+{
+	// draw using local axes
+	glm::vec2 localX(std::cos(rotation), std::sin(rotation));
+	glm::vec2 localY(-localX.y, localX.x);
+	glm::vec2 p1 = position - localX * extents.x - localY * extents.y;
+	glm::vec2 p2 = position + localX * extents.x - localY * extents.y;
+	glm::vec2 p3 = position - localX * extents.x + localY * extents.y;
+	glm::vec2 p4 = position + localX * extents.x + localY * extents.y;
+	aie::Gizmos::add2DTri(p1, p2, p4, color);
+	aie::Gizmos::add2DTri(p1, p4, p3, color);
+}
+
+void PhysicsGizmos::draw(const PhysicsScene& scene)
+{
+	PROFILE_ZONE("PhysicsGizmos::draw");
+
+	float alpha = scene.getInterpolationAlpha();
+	bool reducedDetail = scene.getGovernor().getLevel().reducedDetail;
+	for (auto pActor : scene.getActors())
+	{
+		drawActor(pActor, alpha, reducedDetail);
+	}
+}
+
+void PhysicsGizmos::draw(const RenderState& state, const float alpha)
+{
+	PROFILE_ZONE("PhysicsGizmos::draw");
+
+	for (auto& plane : state.planes)
+	{
+		drawPlane(plane.normal, plane.distance);
+	}
+
+	for (auto& body : state.bodies)
+	{
+		glm::vec2 position = body.previousPosition + (body.position - body.previousPosition) * alpha;
+		float rotation = body.previousRotation + (body.rotation - body.previousRotation) * alpha;
+
+		switch (body.shape)
+		{
+		case SPHERE:
+			drawSphere(position, rotation, body.size.x, body.color, state.stats.reducedDetail);
+			break;
+		case AABB:
+			drawAabb(position, body.size, body.color);
+			break;
+		case BOX:
+			drawBox(position, rotation, body.size, body.color);
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+void PhysicsGizmos::drawActor(const PhysicsObject* actor, const float alpha, const bool reducedDetail)
+{
+	switch (actor->getShapeID())
+	{
+	case PLANE:
+	{
+		const Plane* plane = static_cast<const Plane*>(actor);
+		drawPlane(plane->getNormal(), plane->getDistance());
+		break;
+	}
+	case SPHERE:
+	{
+		const Sphere* sphere = static_cast<const Sphere*>(actor);
+		drawSphere(sphere->getInterpolatedPosition(alpha), sphere->getInterpolatedRotation(alpha), sphere->getRadius(),
+			sphere->getColor(), reducedDetail);
+		break;
+	}
+	case AABB:
+	{
+		const Aabb* aabb = static_cast<const Aabb*>(actor);
+		drawAabb(aabb->getInterpolatedPosition(alpha), aabb->getExtents(), aabb->getColor());
+		break;
+	}
+	case BOX:
+	{
+		const Box* box = static_cast<const Box*>(actor);
+		drawBox(box->getInterpolatedPosition(alpha), box->getInterpolatedRotation(alpha), box->getExtents(), box->getColor());
+		break;
+	}
+	default:
+		break;
+	}
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+class PhysicsScene;
+class PhysicsObject;
+struct RenderState;
+
+// draws a scene with aie::Gizmos. the physics library doesn't know how to
+// draw anything, so this lives with the app
+namespace PhysicsGizmos
+{
+	// adds every actor in the scene to the gizmos, blended between their
+	// last two steps by the scene's interpolation alpha. spheres are drawn
+	// with less detail while the scene's governor is lowering the quality
+	void draw(const PhysicsScene& scene);
+
+	// the same from a copy of the scene, for when it's stepping on a
+	// PhysicsThread
+	void draw(const RenderState& state, const float alpha);
+
+	void drawActor(const PhysicsObject* actor, const float alpha = 1.0f, const bool reducedDetail = false);
+}
@@ -0,0 +1,172 @@
+#include "BenchmarkScenes.h"
+#include "PhysicsScene.h"
+#include "Sphere.h"
+#include "Box.h"
+#include "Aabb.h"
+#include "Plane.h"
+#include <glm/ext.hpp>
+#include <cmath>
+#include <cstdint>
+
+// a fixed xorshift so every platform builds exactly the same scenes, the
+// standard library's distributions aren't the same everywhere
+static uint32_t s_random = 2463534242u;
+
+static float randomFloat(const float min, const float max)
+{
+	s_random ^= s_random << 13;
+	s_random ^= s_random >> 17;
+	s_random ^= s_random << 5;
+	return min + (max - min) * (s_random / 4294967296.0f);
+}
+
+static Plane* addPlane(PhysicsScene& scene, const float x, const float y, const float distance)
+{
+	Plane* plane = scene.create<Plane>();
+	plane->setNormal(x, y);
+	plane->setDistance(distance);
+	scene.addActor(plane);
+	return plane;
+}
+
+static Sphere* makeSphere(PhysicsScene& scene, const glm::vec2 position, const float radius)
+{
+	Sphere* ball = scene.create<Sphere>();
+	ball->setPosition(position);
+	ball->setMass(1);
+	ball->setRadius(radius);
+	ball->setElasticity(0.3f);
+	ball->calculateMoment();
+	return ball;
+}
+
+void BenchmarkScenes::buildRing(PhysicsScene& scene, const int bodies)
+{
+	s_random = 2463534242u;
+	scene.setGravity(glm::vec2(0, -100));
+
+	// the same planes and ring as PhysicsApp::startup in a 1280x720 window
+	addPlane(scene, 1, 2, 300);
+	addPlane(scene, 1, -2, 300);
+
+	glm::vec2 center(640, 360);
+	int numBoxes = 16;
+	for (int i = 0; i < numBoxes; i++)
+	{
+		float theta = glm::radians(i * 360.0f / (float)numBoxes);
+
+		Box* box = scene.create<Box>();
+		box->setHeight(10);
+		box->setWidth(10);
+		box->setPosition(center + glm::vec2(std::sin(theta), -std::cos(theta)) * 200.0f);
+		box->setMass(1);
+		box->setKinematic(true);
+		box->calculateMoment();
+		scene.addActor(box);
+	}
+
+	// the spheres start in a column above the ring
+	scene.getPool<Sphere>().reserve(bodies);
+	int columns = 16;
+	for (int i = 0; i < bodies; i++)
+	{
+		glm::vec2 position(center.x - 150 + (i % columns) * 20.0f + randomFloat(-2, 2), center.y + (i / columns) * 20.0f);
+		scene.addActor(makeSphere(scene, position, 8));
+	}
+}
+
+void BenchmarkScenes::buildPyramids(PhysicsScene& scene, const int bodies)
+{
+	s_random = 2463534242u;
+	scene.setGravity(glm::vec2(0, -100));
+	addPlane(scene, 0, 1, 0);
+
+	// as many pyramids with a base of 20 boxes as it takes
+	int base = 20;
+	float size = 10;
+	scene.getPool<Box>().reserve(bodies);
+
+	int count = 0;
+	for (int pyramid = 0; count < bodies; pyramid++)
+	{
+		float left = pyramid * (base + 4) * size;
+		for (int row = 0; row < base && count < bodies; row++)
+		{
+			for (int column = 0; column < base - row && count < bodies; column++)
+			{
+				Box* box = scene.create<Box>();
+				box->setWidth(size);
+				box->setHeight(size);
+				box->setMass(1);
+				box->setElasticity(0);
+				box->setPosition(left + (column + row * 0.5f) * size, size * 0.5f + row * size);
+				box->calculateMoment();
+				scene.addActor(box);
+				count++;
+			}
+		}
+	}
+}
+
+void BenchmarkScenes::buildMixed(PhysicsScene& scene, const int bodies)
+{
+	s_random = 2463534242u;
+	scene.setGravity(glm::vec2(0, -100));
+
+	int columns = 80;
+	float spacing = 16;
+	addPlane(scene, 0, 1, 0);
+	addPlane(scene, 1, 0, 0);
+	addPlane(scene, -1, 0, -(columns + 1) * spacing);
+
+	scene.getPool<Sphere>().reserve(bodies / 2 + 1);
+	scene.getPool<Aabb>().reserve(bodies / 2 + 1);
+
+	for (int i = 0; i < bodies; i++)
+	{
+		glm::vec2 position((1 + i % columns) * spacing + randomFloat(-2, 2), (1 + i / columns) * spacing);
+
+		if (i % 2 == 0)
+		{
+			scene.addActor(makeSphere(scene, position, randomFloat(4, 6)));
+		}
+		else
+		{
+			Aabb* aabb = scene.create<Aabb>();
+			aabb->setWidth(randomFloat(8, 12));
+			aabb->setHeight(randomFloat(8, 12));
+			aabb->setMass(1);
+			aabb->setElasticity(0.3f);
+			aabb->setPosition(position);
+			scene.addActor(aabb);
+		}
+	}
+}
+
+void BenchmarkScenes::buildGas(PhysicsScene& scene, const int bodies)
+{
+	s_random = 2463534242u;
+	scene.setGravity(glm::vec2(0, 0));
+
+	// about a third of the box is filled
+	float radius = 3;
+	float side = std::sqrt((float)bodies) * radius * 4;
+	addPlane(scene, 0, 1, 0);
+	addPlane(scene, 0, -1, -side);
+	addPlane(scene, 1, 0, 0);
+	addPlane(scene, -1, 0, -side);
+
+	scene.getPool<Sphere>().reserve(bodies);
+	int columns = (int)std::ceil(std::sqrt((float)bodies));
+	float spacing = side / (columns + 1);
+
+	for (int i = 0; i < bodies; i++)
+	{
+		glm::vec2 position((1 + i % columns) * spacing, (1 + i / columns) * spacing);
+		Sphere* ball = makeSphere(scene, position, radius);
+		ball->setElasticity(1);
+		ball->setFriction(0);
+		ball->setVelocity(randomFloat(-100, 100), randomFloat(-100, 100));
+		scene.addActor(ball);
+	}
+}
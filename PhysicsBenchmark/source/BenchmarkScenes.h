@@ -0,0 +1,41 @@
+#pragma once
+
+class PhysicsScene;
+
+// the scenes the benchmark runs. every scene is built the same way each
+// time so the numbers can be compared between builds
+namespace BenchmarkScenes
+{
+	struct Scene
+	{
+		const char* name;
+		const char* description;
+
+		// how many bodies the scene has unless told otherwise
+		int defaultBodies;
+
+		// adds the scene's actors to an empty scene
+		void(*build)(PhysicsScene& scene, const int bodies);
+	};
+
+	// the kinematic ring from the app with spheres dropped into it
+	void buildRing(PhysicsScene& scene, const int bodies);
+
+	// pyramids of boxes standing on a plane
+	void buildPyramids(PhysicsScene& scene, const int bodies);
+
+	// aabbs and spheres falling onto a plane together
+	void buildMixed(PhysicsScene& scene, const int bodies);
+
+	// spheres bouncing around a closed box with no gravity
+	void buildGas(PhysicsScene& scene, const int bodies);
+
+	static const Scene SCENES[] =
+	{
+		{ "ring", "kinematic ring of boxes with falling spheres", 1000, &buildRing },
+		{ "pyramids", "box pyramids on a plane", 1000, &buildPyramids },
+		{ "mixed", "field of aabbs and spheres on a plane", 2000, &buildMixed },
+		{ "gas", "spheres with no gravity in a closed box", 4000, &buildGas },
+	};
+	static const int SCENE_COUNT = sizeof(SCENES) / sizeof(SCENES[0]);
+}
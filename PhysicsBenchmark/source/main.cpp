@@ -0,0 +1,298 @@
+#include "BenchmarkScenes.h"
+#include "PhysicsScene.h"
+#include "SpatialHash.h"
+#include "DynamicTree.h"
+#include "SweepAndPrune.h"
+#include "SimdMath.h"
+#include "Profiler.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+// runs the benchmark scenes headless and writes the results as json
+//
+// usage: PhysicsBenchmark [options]
+//   --scene <name>       only run one scene, see --list
+//   --bodies <count>     bodies per scene instead of the scene's default
+//   --steps <count>      timed steps per scene (1000)
+//   --warmup <count>     untimed steps before timing starts (100)
+//   --threads <count>    threads the scene uses (all of them)
+//   --broadphase <name>  hash, tree, sap or none (hash)
+//   --out <file>         where the json goes (stdout)
+//   --trace <file>       write the timed steps as a chrome trace
+//   --list               print the scenes and quit
+
+struct Options
+{
+	const char* scene = nullptr;
+	int bodies = 0;
+	int steps = 1000;
+	int warmup = 100;
+	int threads = (int)std::thread::hardware_concurrency();
+	const char* broadphase = "hash";
+	const char* out = nullptr;
+	const char* trace = nullptr;
+};
+
+struct Result
+{
+	const BenchmarkScenes::Scene* scene;
+	int bodies;
+	double milliseconds;
+	double maxStepMilliseconds;
+	PhysicsScene::StepTimings phases;
+	double contacts;
+	double checksum;
+};
+
+static Broadphase* makeBroadphase(const char* name)
+{
+	if (strcmp(name, "hash") == 0)
+	{
+		return new SpatialHash(32.0f);
+	}
+	if (strcmp(name, "tree") == 0)
+	{
+		return new DynamicTree();
+	}
+	if (strcmp(name, "sap") == 0)
+	{
+		return new SweepAndPrune();
+	}
+	return nullptr;
+}
+
+static const char* getSimdName()
+{
+#if defined(PHYSICS_SIMD_AVX2)
+	return "avx2";
+#elif defined(PHYSICS_SIMD_SSE2)
+	return "sse2";
+#else
+	return "scalar";
+#endif
+}
+
+static Result run(const BenchmarkScenes::Scene& benchmark, const Options& options)
+{
+	Result result = {};
+	result.scene = &benchmark;
+	result.bodies = options.bodies > 0 ? options.bodies : benchmark.defaultBodies;
+
+	PhysicsScene* physicsScene = new PhysicsScene();
+	physicsScene->setTimeStep(0.01f);
+	physicsScene->setThreadCount(options.threads);
+	physicsScene->setBroadphase(makeBroadphase(options.broadphase));
+	benchmark.build(*physicsScene, result.bodies);
+
+	for (int i = 0; i < options.warmup; i++)
+	{
+		physicsScene->step();
+	}
+
+	// only the timed steps go in the trace
+	Profiler::setEnabled(options.trace != nullptr);
+
+	typedef std::chrono::high_resolution_clock Clock;
+	Clock::time_point start = Clock::now();
+
+	for (int i = 0; i < options.steps; i++)
+	{
+		Clock::time_point stepStart = Clock::now();
+		physicsScene->step();
+		double stepMilliseconds = std::chrono::duration<double, std::milli>(Clock::now() - stepStart).count();
+		Profiler::endFrame();
+
+		const PhysicsScene::StepTimings& timings = physicsScene->getStepTimings();
+		result.phases.integrate += timings.integrate;
+		result.phases.pairs += timings.pairs;
+		result.phases.narrowphase += timings.narrowphase;
+		result.phases.response += timings.response;
+		result.phases.sleeping += timings.sleeping;
+		result.contacts += (double)physicsScene->getContacts().size();
+		if (stepMilliseconds > result.maxStepMilliseconds)
+		{
+			result.maxStepMilliseconds = stepMilliseconds;
+		}
+	}
+
+	result.milliseconds = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	Profiler::setEnabled(false);
+
+	// the same build with the same options should always give the same sum
+	for (auto pActor : physicsScene->getActors())
+	{
+		if (pActor->getShapeID() != PLANE)
+		{
+			glm::vec2 min, max;
+			pActor->getBounds(min, max);
+			result.checksum += (double)min.x + min.y + max.x + max.y;
+		}
+	}
+
+	delete physicsScene;
+	return result;
+}
+
+static void writeJson(FILE* file, const Options& options, const Result* results, const int resultCount)
+{
+	fprintf(file, "{\n");
+	fprintf(file, "  \"build\": {\n");
+#if defined(NDEBUG)
+	fprintf(file, "    \"config\": \"release\",\n");
+#else
+	fprintf(file, "    \"config\": \"debug\",\n");
+#endif
+	fprintf(file, "    \"simd\": \"%s\",\n", getSimdName());
+#if defined(_MSC_VER)
+	fprintf(file, "    \"compiler\": \"msvc %d\"\n", _MSC_VER);
+#elif defined(__clang__)
+	fprintf(file, "    \"compiler\": \"clang %d.%d\"\n", __clang_major__, __clang_minor__);
+#elif defined(__GNUC__)
+	fprintf(file, "    \"compiler\": \"gcc %d.%d\"\n", __GNUC__, __GNUC_MINOR__);
+#else
+	fprintf(file, "    \"compiler\": \"unknown\"\n");
+#endif
+	fprintf(file, "  },\n");
+	fprintf(file, "  \"options\": {\n");
+	fprintf(file, "    \"steps\": %d,\n", options.steps);
+	fprintf(file, "    \"warmup\": %d,\n", options.warmup);
+	fprintf(file, "    \"threads\": %d,\n", options.threads);
+	fprintf(file, "    \"broadphase\": \"%s\"\n", options.broadphase);
+	fprintf(file, "  },\n");
+	fprintf(file, "  \"scenes\": [\n");
+
+	for (int i = 0; i < resultCount; i++)
+	{
+		const Result& result = results[i];
+		double steps = (double)options.steps;
+
+		// per phase times are averaged over the steps
+		fprintf(file, "    {\n");
+		fprintf(file, "      \"name\": \"%s\",\n", result.scene->name);
+		fprintf(file, "      \"bodies\": %d,\n", result.bodies);
+		fprintf(file, "      \"steps_per_second\": %.3f,\n", result.milliseconds > 0 ? steps * 1000.0 / result.milliseconds : 0.0);
+		fprintf(file, "      \"ms_per_step\": %.6f,\n", result.milliseconds / steps);
+		fprintf(file, "      \"max_step_ms\": %.6f,\n", result.maxStepMilliseconds);
+		fprintf(file, "      \"phases_ms\": {\n");
+		fprintf(file, "        \"integrate\": %.6f,\n", result.phases.integrate / steps);
+		fprintf(file, "        \"pairs\": %.6f,\n", result.phases.pairs / steps);
+		fprintf(file, "        \"narrowphase\": %.6f,\n", result.phases.narrowphase / steps);
+		fprintf(file, "        \"response\": %.6f,\n", result.phases.response / steps);
+		fprintf(file, "        \"sleeping\": %.6f\n", result.phases.sleeping / steps);
+		fprintf(file, "      },\n");
+		fprintf(file, "      \"contacts\": %.1f,\n", result.contacts / steps);
+		fprintf(file, "      \"checksum\": %.6f\n", result.checksum);
+		fprintf(file, "    }%s\n", i + 1 < resultCount ? "," : "");
+	}
+
+	fprintf(file, "  ]\n");
+	fprintf(file, "}\n");
+}
+
+int main(int argc, char* argv[])
+{
+	Options options;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+
+		if (arg == "--list")
+		{
+			for (auto& scene : BenchmarkScenes::SCENES)
+			{
+				printf("%-10s %s (%d bodies)\n", scene.name, scene.description, scene.defaultBodies);
+			}
+			return 0;
+		}
+		else if (arg == "--scene" && hasValue)
+		{
+			options.scene = argv[++i];
+		}
+		else if (arg == "--bodies" && hasValue)
+		{
+			options.bodies = atoi(argv[++i]);
+		}
+		else if (arg == "--steps" && hasValue)
+		{
+			options.steps = atoi(argv[++i]);
+		}
+		else if (arg == "--warmup" && hasValue)
+		{
+			options.warmup = atoi(argv[++i]);
+		}
+		else if (arg == "--threads" && hasValue)
+		{
+			options.threads = atoi(argv[++i]);
+		}
+		else if (arg == "--broadphase" && hasValue)
+		{
+			options.broadphase = argv[++i];
+		}
+		else if (arg == "--out" && hasValue)
+		{
+			options.out = argv[++i];
+		}
+		else if (arg == "--trace" && hasValue)
+		{
+			options.trace = argv[++i];
+		}
+		else
+		{
+			fprintf(stderr, "unknown option %s\n", arg.c_str());
+			return 1;
+		}
+	}
+
+	if (options.steps < 1)
+	{
+		options.steps = 1;
+	}
+
+	Result results[BenchmarkScenes::SCENE_COUNT];
+	int resultCount = 0;
+
+	for (auto& scene : BenchmarkScenes::SCENES)
+	{
+		if (options.scene != nullptr && strcmp(options.scene, scene.name) != 0)
+		{
+			continue;
+		}
+
+		// progress goes to stderr so stdout is just the json
+		fprintf(stderr, "%s...", scene.name);
+		results[resultCount] = run(scene, options);
+		fprintf(stderr, " %.3f ms per step\n", results[resultCount].milliseconds / options.steps);
+		resultCount++;
+	}
+
+	if (resultCount == 0)
+	{
+		fprintf(stderr, "no scene called %s, see --list\n", options.scene);
+		return 1;
+	}
+
+	if (options.trace != nullptr && !Profiler::writeChromeTrace(options.trace))
+	{
+		fprintf(stderr, "couldn't write %s\n", options.trace);
+		return 1;
+	}
+
+	FILE* file = options.out != nullptr ? fopen(options.out, "w") : stdout;
+	if (file == nullptr)
+	{
+		fprintf(stderr, "couldn't open %s\n", options.out);
+		return 1;
+	}
+	writeJson(file, options, results, resultCount);
+	if (file != stdout)
+	{
+		fclose(file);
+	}
+	return 0;
+}
@@ -0,0 +1,116 @@
+#include "PhysicsScene.h"
+#include "Sphere.h"
+#include "Box.h"
+#include "Plane.h"
+#include "SpatialHash.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+// runs the physics without a window so it can go on servers and in
+// benchmarks. usage: PhysicsHeadless [bodies] [steps] [threads]
+int main(int argc, char* argv[])
+{
+	int bodyCount = argc > 1 ? atoi(argv[1]) : 1000;
+	int stepCount = argc > 2 ? atoi(argv[2]) : 1000;
+	int threadCount = argc > 3 ? atoi(argv[3]) : (int)std::thread::hardware_concurrency();
+
+	PhysicsScene* physicsScene = new PhysicsScene();
+	physicsScene->setGravity(glm::vec2(0, -100));
+	physicsScene->setTimeStep(0.01f);
+	physicsScene->setThreadCount(threadCount);
+	physicsScene->setBroadphase(new SpatialHash(64.0f));
+
+	// a floor and two walls
+	Plane* floor = physicsScene->create<Plane>();
+	floor->setNormal(0, 1);
+	floor->setDistance(0);
+	physicsScene->addActor(floor);
+
+	Plane* leftWall = physicsScene->create<Plane>();
+	leftWall->setNormal(1, 0);
+	leftWall->setDistance(0);
+	physicsScene->addActor(leftWall);
+
+	Plane* rightWall = physicsScene->create<Plane>();
+	rightWall->setNormal(-1, 0);
+	rightWall->setDistance(-1280);
+	physicsScene->addActor(rightWall);
+
+	// a grid of alternating spheres and boxes dropped onto the floor
+	physicsScene->getPool<Sphere>().reserve(bodyCount / 2 + 1);
+	physicsScene->getPool<Box>().reserve(bodyCount / 2 + 1);
+
+	std::vector<PhysicsObject*> bodies;
+	bodies.reserve(bodyCount);
+	int columns = 60;
+	for (int i = 0; i < bodyCount; i++)
+	{
+		glm::vec2 position(20 + (i % columns) * 20.0f + (i / columns % 2) * 5.0f, 20 + (i / columns) * 20.0f);
+
+		if (i % 2 == 0)
+		{
+			Sphere* ball = physicsScene->create<Sphere>();
+			ball->setRadius(8);
+			ball->setMass(1);
+			ball->setElasticity(0.3f);
+			ball->setPosition(position);
+			ball->calculateMoment();
+			bodies.push_back(ball);
+		}
+		else
+		{
+			Box* box = physicsScene->create<Box>();
+			box->setWidth(14);
+			box->setHeight(14);
+			box->setMass(1);
+			box->setElasticity(0.3f);
+			box->setPosition(position);
+			box->setRotation(i * 0.1f);
+			box->calculateMoment();
+			bodies.push_back(box);
+		}
+	}
+	physicsScene->addActors(bodies);
+
+	printf("%d bodies, %d steps, %d threads\n", bodyCount, stepCount, physicsScene->getThreadCount());
+
+	auto start = std::chrono::high_resolution_clock::now();
+	auto reportStart = start;
+	int reportEvery = 100;
+
+	for (int step = 1; step <= stepCount; step++)
+	{
+		physicsScene->update(physicsScene->getTimeStep());
+
+		if (step % reportEvery == 0 || step == stepCount)
+		{
+			auto now = std::chrono::high_resolution_clock::now();
+			double milliseconds = std::chrono::duration<double, std::milli>(now - reportStart).count();
+			int steps = step % reportEvery == 0 ? reportEvery : step % reportEvery;
+			printf("step %d: %zu contacts, %.3f ms per step\n", step, physicsScene->getContacts().size(), milliseconds / steps);
+			reportStart = now;
+		}
+	}
+
+	double totalMilliseconds = std::chrono::duration<double, std::milli>(
+		std::chrono::high_resolution_clock::now() - start).count();
+
+	// a sum of every position, the same build with the same arguments
+	// should always give the same number
+	double checksum = 0;
+	for (auto pActor : physicsScene->getActors())
+	{
+		glm::vec2 min, max;
+		pActor->getBounds(min, max);
+		if (pActor->getShapeID() != PLANE)
+		{
+			checksum += (double)min.x + min.y + max.x + max.y;
+		}
+	}
+
+	printf("total %.1f ms, %.3f ms per step, checksum %.6f\n", totalMilliseconds, totalMilliseconds / stepCount, checksum);
+
+	delete physicsScene;
+	return 0;
+}
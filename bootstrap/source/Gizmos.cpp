@@ -3,6 +3,7 @@
 #include <glm/glm.hpp>
 #include <glm/ext.hpp>
 #include <iostream>
+#include "Profiler.h"
 
 namespace aie {
 
@@ -173,6 +174,22 @@ void Gizmos::clear() {
 	sm_singleton->m_2DtriCount = 0;
 }
 
+unsigned int Gizmos::get2DLineCount() {
+	return sm_singleton != nullptr ? sm_singleton->m_2DlineCount : 0;
+}
+
+unsigned int Gizmos::getMax2DLines() {
+	return sm_singleton != nullptr ? sm_singleton->m_max2DLines : 0;
+}
+
+unsigned int Gizmos::get2DTriCount() {
+	return sm_singleton != nullptr ? sm_singleton->m_2DtriCount : 0;
+}
+
+unsigned int Gizmos::getMax2DTris() {
+	return sm_singleton != nullptr ? sm_singleton->m_max2DTris : 0;
+}
+
 // Adds 3 unit-length lines (red,green,blue) representing the 3 axis of a transform, 
 // at the transform's translation. Optional scale available.
 void Gizmos::addTransform(const glm::mat4& transform, float scale) {
@@ -999,6 +1016,8 @@ void Gizmos::draw2D(float screenWidth, float screenHeight) {
 }
 
 void Gizmos::draw2D(const glm::mat4& projection) {
+	PROFILE_ZONE("Gizmos::draw2D");
+
 	if ( sm_singleton != nullptr && 
 		(sm_singleton->m_2DlineCount > 0 || 
 		 sm_singleton->m_2DtriCount > 0)) {
@@ -1016,6 +1035,8 @@ void Gizmos::draw2D(const glm::mat4& projection) {
 
 			glBindVertexArray(sm_singleton->m_2DlineVAO);
 			glDrawArrays(GL_LINES, 0, sm_singleton->m_2DlineCount * 2);
+			PROFILE_COUNT(DRAW_CALLS, 1);
+			PROFILE_COUNT(VERTICES_FLUSHED, sm_singleton->m_2DlineCount * 2);
 		}
 
 		if (sm_singleton->m_2DtriCount > 0) {
@@ -1040,6 +1061,8 @@ void Gizmos::draw2D(const glm::mat4& projection) {
 
 			glBindVertexArray(sm_singleton->m_2DtriVAO);
 			glDrawArrays(GL_TRIANGLES, 0, sm_singleton->m_2DtriCount * 3);
+			PROFILE_COUNT(DRAW_CALLS, 1);
+			PROFILE_COUNT(VERTICES_FLUSHED, sm_singleton->m_2DtriCount * 3);
 
 			glDepthMask(depthMask);
 
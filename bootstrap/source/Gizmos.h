@@ -23,6 +23,12 @@ public:
 	static void		draw2D(const glm::mat4& projection);
 	static void		draw2D(float screenWidth, float screenHeight);
 
+	// how much of the 2D buffers has been used since the last clear
+	static unsigned int	get2DLineCount();
+	static unsigned int	getMax2DLines();
+	static unsigned int	get2DTriCount();
+	static unsigned int	getMax2DTris();
+
 	// adds a single debug line
 	static void		addLine(const glm::vec3& v0, const glm::vec3& v1, const glm::vec4& colour);
 
@@ -3,6 +3,7 @@
 #include "Renderer2D.h"
 #include "Texture.h"
 #include "Font.h"
+#include "Profiler.h"
 #include <glm/ext.hpp>
 #include <stb_truetype.h>
 
@@ -21,6 +22,8 @@ Renderer2D::Renderer2D() {
 
 	m_currentVertex = 0;
 	m_currentIndex = 0;
+	m_peakBatchVertices = 0;
+	m_flushCount = 0;
 	m_renderBegun = false;
 
 	m_vao = -1;
@@ -150,6 +153,8 @@ void Renderer2D::begin() {
 	m_currentIndex = 0;
 	m_currentVertex = 0;
 	m_currentTexture = 0;
+	m_peakBatchVertices = 0;
+	m_flushCount = 0;
 
 	int width = 0, height = 0;
 	auto window = glfwGetCurrentContext();
@@ -643,6 +648,7 @@ bool Renderer2D::shouldFlush(int additionalVertices, int additionalIndices) {
 }
 
 void Renderer2D::flushBatch() {
+	PROFILE_ZONE("Renderer2D::flushBatch");
 
 	// dont render anything
 	if (m_currentVertex == 0 || m_currentIndex == 0 || m_renderBegun == false)
@@ -665,6 +671,11 @@ void Renderer2D::flushBatch() {
 	glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, m_currentIndex * sizeof(unsigned short), m_indices);
 
 	glDrawElements(GL_TRIANGLES, m_currentIndex, GL_UNSIGNED_SHORT, 0);
+	if (m_currentVertex > m_peakBatchVertices)
+		m_peakBatchVertices = m_currentVertex;
+	m_flushCount++;
+	PROFILE_COUNT(DRAW_CALLS, 1);
+	PROFILE_COUNT(VERTICES_FLUSHED, m_currentVertex);
 
 	glBindVertexArray(0);
 
@@ -46,6 +46,11 @@ public:
 	void setCameraPos(float x, float y) { m_cameraX = x; m_cameraY = y; }
 	void getCameraPos(float& x, float& y) const { x = m_cameraX; y = m_cameraY; }
 
+	// the fullest batch and the number of batches flushed since begin
+	int getPeakBatchVertices() const { return m_peakBatchVertices; }
+	int getMaxBatchVertices() const { return MAX_SPRITES * 4; }
+	int getFlushCount() const { return m_flushCount; }
+
 protected:
 
 	// helper methods used during drawing
@@ -84,6 +89,7 @@ protected:
 	SBVertex			m_vertices[MAX_SPRITES * 4];
 	unsigned short		m_indices[MAX_SPRITES * 6];
 	int					m_currentVertex, m_currentIndex;
+	int					m_peakBatchVertices, m_flushCount;
 	unsigned int		m_vao, m_vbo, m_ibo;
 
 	// shader used to render sprites
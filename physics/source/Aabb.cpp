@@ -1,7 +1,6 @@
-#include "AABB.h"
-#include <Gizmos.h>
+#include "Aabb.h"
 #include <iostream>
-#include <glm\ext.hpp>
+#include <glm/ext.hpp>
 
 Aabb::Aabb() :
 	RigidBody(ShapeTypes::AABB)
@@ -9,16 +8,10 @@ Aabb::Aabb() :
 	// m_moment = 1.0f / 6.0f * m_mass * (extents.x * 2) * (m_extents.y * 2);
 }
 
-// adds an AIE Gizmo to the scene
-void Aabb::draw()
-{
-	aie::Gizmos::add2DAABBFilled(m_position, m_extents, m_color);
-}
-
 // returns the corner position
 glm::vec2 Aabb::getCorner(const int corner) const
 {
-	glm::vec2 cornerPos = m_position;
+	glm::vec2 cornerPos = getPosition();
 
 	switch (corner)
 	{
@@ -45,13 +38,21 @@ glm::vec2 Aabb::getCorner(const int corner) const
 	return cornerPos;
 }
 
+void Aabb::calculateBounds()
+{
+	m_boundsMin = getMin();
+	m_boundsMax = getMax();
+}
+
 bool Aabb::containsPoint(const glm::vec2 point) const
 {
-	if (point.x > m_position.x + m_extents.x || point.x < m_position.x - m_extents.x)
+	glm::vec2 position = getPosition();
+
+	if (point.x > position.x + m_extents.x || point.x < position.x - m_extents.x)
 	{
 		return false;
 	}
-	if (point.y > m_position.y + m_extents.y || point.y < m_position.y - m_extents.y)
+	if (point.y > position.y + m_extents.y || point.y < position.y - m_extents.y)
 	{
 		return false;
 	}
@@ -1,6 +1,6 @@
 #pragma once
 #include "RigidBody.h"
-#include <glm\common.hpp>
+#include <glm/common.hpp>
 
 // Axis Aligned Bounding Box
 class Aabb : public RigidBody
@@ -10,15 +10,15 @@ public:
 
 	~Aabb() {};
 
-	virtual void draw();
+	virtual void calculateBounds();
 
 	glm::vec2 getExtents() const { return m_extents; }
 
 	float getWidth() const { return (m_extents.x * 2); }
 	float getHeight() const { return (m_extents.y * 2); }
 
-	glm::vec2 getMin() const { return m_position - m_extents; }
-	glm::vec2 getMax() const { return m_position + m_extents; }
+	glm::vec2 getMin() const { return getPosition() - m_extents; }
+	glm::vec2 getMax() const { return getPosition() + m_extents; }
 
 	glm::vec2 getCorner(const int corner) const;
 	bool containsPoint(const glm::vec2 point) const;
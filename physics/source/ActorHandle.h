@@ -0,0 +1,17 @@
+#pragma once
+#include <cstdint>
+
+// refers to an actor in a PhysicsScene without holding on to a pointer.
+// the scene bumps a slot's generation when its actor is removed, so old
+// handles stop resolving instead of dangling once the slot is reused
+struct ActorHandle
+{
+	uint32_t index = 0;
+	uint32_t generation = 0;
+
+	// live slots never have generation 0, so a default handle is null
+	bool isNull() const { return generation == 0; }
+
+	bool operator==(const ActorHandle& other) const { return index == other.index && generation == other.generation; }
+	bool operator!=(const ActorHandle& other) const { return !(*this == other); }
+};
@@ -0,0 +1,229 @@
+#include "AllocationCounter.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<size_t> s_allocationCount(0);
+static thread_local size_t s_threadAllocationCount = 0;
+
+static std::atomic<bool> s_tracking(false);
+static thread_local AllocationCounter::Tag s_tag = AllocationCounter::OTHER;
+
+static std::atomic<size_t> s_allocations[AllocationCounter::TAG_COUNT];
+static std::atomic<size_t> s_frees[AllocationCounter::TAG_COUNT];
+static std::atomic<size_t> s_bytesAllocated[AllocationCounter::TAG_COUNT];
+static std::atomic<size_t> s_bytesFreed[AllocationCounter::TAG_COUNT];
+
+size_t AllocationCounter::getCount()
+{
+	return s_allocationCount.load(std::memory_order_relaxed);
+}
+
+size_t AllocationCounter::getThreadCount()
+{
+	return s_threadAllocationCount;
+}
+
+void AllocationCounter::setTracking(const bool tracking)
+{
+	s_tracking = tracking;
+}
+
+bool AllocationCounter::isTracking()
+{
+	return s_tracking;
+}
+
+AllocationCounter::Tag AllocationCounter::getTag()
+{
+	return s_tag;
+}
+
+AllocationCounter::Tag AllocationCounter::setTag(const Tag tag)
+{
+	Tag previous = s_tag;
+	s_tag = tag;
+	return previous;
+}
+
+const char* AllocationCounter::getTagName(const Tag tag)
+{
+	static const char* names[TAG_COUNT] = { "other", "physics", "gizmos", "renderer", "framework" };
+	return names[tag];
+}
+
+AllocationCounter::Snapshot AllocationCounter::Snapshot::since(const Snapshot& earlier) const
+{
+	Snapshot difference;
+	for (int i = 0; i < TAG_COUNT; i++)
+	{
+		difference.allocations[i] = allocations[i] - earlier.allocations[i];
+		difference.frees[i] = frees[i] - earlier.frees[i];
+		difference.bytesAllocated[i] = bytesAllocated[i] - earlier.bytesAllocated[i];
+		difference.bytesFreed[i] = bytesFreed[i] - earlier.bytesFreed[i];
+	}
+	return difference;
+}
+
+AllocationCounter::Snapshot AllocationCounter::Snapshot::only(const Tag tag) const
+{
+	Snapshot result = {};
+	result.allocations[tag] = allocations[tag];
+	result.frees[tag] = frees[tag];
+	result.bytesAllocated[tag] = bytesAllocated[tag];
+	result.bytesFreed[tag] = bytesFreed[tag];
+	return result;
+}
+
+size_t AllocationCounter::Snapshot::getTotalAllocations() const
+{
+	size_t total = 0;
+	for (int i = 0; i < TAG_COUNT; i++)
+	{
+		total += allocations[i];
+	}
+	return total;
+}
+
+size_t AllocationCounter::Snapshot::getTotalBytes() const
+{
+	size_t total = 0;
+	for (int i = 0; i < TAG_COUNT; i++)
+	{
+		total += bytesAllocated[i];
+	}
+	return total;
+}
+
+AllocationCounter::Snapshot AllocationCounter::getSnapshot()
+{
+	Snapshot snapshot;
+	for (int i = 0; i < TAG_COUNT; i++)
+	{
+		snapshot.allocations[i] = s_allocations[i].load(std::memory_order_relaxed);
+		snapshot.frees[i] = s_frees[i].load(std::memory_order_relaxed);
+		snapshot.bytesAllocated[i] = s_bytesAllocated[i].load(std::memory_order_relaxed);
+		snapshot.bytesFreed[i] = s_bytesFreed[i].load(std::memory_order_relaxed);
+	}
+	return snapshot;
+}
+
+void AllocationCounter::writeCsvHeader(FILE* file)
+{
+	fprintf(file, "window,index,tag,allocations,frees,bytes_allocated,bytes_freed\n");
+}
+
+void AllocationCounter::writeCsv(FILE* file, const char* window, const int index, const Snapshot& snapshot)
+{
+	for (int i = 0; i < TAG_COUNT; i++)
+	{
+		fprintf(file, "%s,%d,%s,%zu,%zu,%zu,%zu\n", window, index, getTagName((Tag)i),
+			snapshot.allocations[i], snapshot.frees[i], snapshot.bytesAllocated[i], snapshot.bytesFreed[i]);
+	}
+}
+
+#if defined(PHYSICS_COUNT_ALLOCATIONS)
+// every block starts with its size and tag so frees can be charged back to
+// whoever made them. 16 bytes keeps the memory after it aligned the same
+// as malloc's
+struct AllocationHeader
+{
+	size_t size;
+	uint32_t tag;
+	uint32_t padding;
+};
+static_assert(sizeof(AllocationHeader) == 16, "the header has to keep blocks 16 byte aligned");
+
+void* operator new(size_t size)
+{
+	s_allocationCount.fetch_add(1, std::memory_order_relaxed);
+	s_threadAllocationCount++;
+
+	AllocationHeader* header = (AllocationHeader*)std::malloc(sizeof(AllocationHeader) + size);
+	if (header == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+	header->size = size;
+	header->tag = s_tag;
+
+	if (s_tracking.load(std::memory_order_relaxed))
+	{
+		s_allocations[s_tag].fetch_add(1, std::memory_order_relaxed);
+		s_bytesAllocated[s_tag].fetch_add(size, std::memory_order_relaxed);
+	}
+	return header + 1;
+}
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+	if (memory == nullptr)
+	{
+		return;
+	}
+
+	AllocationHeader* header = (AllocationHeader*)memory - 1;
+	if (s_tracking.load(std::memory_order_relaxed))
+	{
+		s_frees[header->tag].fetch_add(1, std::memory_order_relaxed);
+		s_bytesFreed[header->tag].fetch_add(header->size, std::memory_order_relaxed);
+	}
+	std::free(header);
+}
+
+void operator delete[](void* memory) noexcept
+{
+	operator delete(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+	operator delete(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept
+{
+	operator delete(memory);
+}
+
+// the nothrow versions have to go through the same header
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+	try
+	{
+		return operator new(size);
+	}
+	catch (...)
+	{
+		return nullptr;
+	}
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+	try
+	{
+		return operator new(size);
+	}
+	catch (...)
+	{
+		return nullptr;
+	}
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept
+{
+	operator delete(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept
+{
+	operator delete(memory);
+}
+#endif
@@ -0,0 +1,82 @@
+#pragma once
+#include <cstddef>
+#include <cstdio>
+
+// counts every heap allocation the program makes, so the physics step can
+// check it isn't allocating. debug builds replace operator new, release
+// builds only do if PHYSICS_TRACK_ALLOCATIONS is defined, otherwise the
+// counts are always 0
+#if !defined(NDEBUG) || defined(PHYSICS_TRACK_ALLOCATIONS)
+#define PHYSICS_COUNT_ALLOCATIONS 1
+#endif
+
+namespace AllocationCounter
+{
+	// the subsystem an allocation is charged to, set per thread with a
+	// ScopedTag. anything outside a scope is OTHER
+	enum Tag
+	{
+		OTHER = 0,
+		PHYSICS,
+		GIZMOS,
+		RENDERER,
+		FRAMEWORK,
+		TAG_COUNT
+	};
+
+	// how many allocations there have been so far, on every thread
+	size_t getCount();
+
+	// how many allocations the calling thread has made so far
+	size_t getThreadCount();
+
+	// the per tag numbers are only kept while tracking is turned on, the
+	// plain counts above are always kept
+	void setTracking(const bool tracking);
+	bool isTracking();
+
+	Tag getTag();
+	Tag setTag(const Tag tag);
+	const char* getTagName(const Tag tag);
+
+	// charges the allocations on this thread to a tag until it goes out of
+	// scope
+	class ScopedTag
+	{
+	public:
+		ScopedTag(const Tag tag) : m_previous(setTag(tag)) {}
+		~ScopedTag() { setTag(m_previous); }
+
+		ScopedTag(const ScopedTag&) = delete;
+		ScopedTag& operator=(const ScopedTag&) = delete;
+
+	private:
+		Tag m_previous;
+	};
+
+	// running totals per tag. frees are charged to the tag that made the
+	// allocation, so bytesAllocated - bytesFreed is what a tag holds on to
+	struct Snapshot
+	{
+		size_t allocations[TAG_COUNT];
+		size_t frees[TAG_COUNT];
+		size_t bytesAllocated[TAG_COUNT];
+		size_t bytesFreed[TAG_COUNT];
+
+		// what happened between earlier and this one
+		Snapshot since(const Snapshot& earlier) const;
+
+		// the same with every other tag zeroed
+		Snapshot only(const Tag tag) const;
+
+		size_t getTotalAllocations() const;
+		size_t getTotalBytes() const;
+	};
+
+	Snapshot getSnapshot();
+
+	// writes a csv row per tag for a window of time, like a frame or a
+	// physics step. writeCsvHeader gives the column names
+	void writeCsvHeader(FILE* file);
+	void writeCsv(FILE* file, const char* window, const int index, const Snapshot& snapshot);
+}
@@ -0,0 +1,426 @@
+#include "BodyStore.h"
+#include "RigidBody.h"
+#include "SimdMath.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+void BodyStore::reserve(const int count)
+{
+	m_positionX.reserve(count);
+	m_positionY.reserve(count);
+	m_velocityX.reserve(count);
+	m_velocityY.reserve(count);
+	m_rotation.reserve(count);
+	m_rotationCos.reserve(count);
+	m_rotationSin.reserve(count);
+	m_angularVelocity.reserve(count);
+	m_previousX.reserve(count);
+	m_previousY.reserve(count);
+	m_previousRotation.reserve(count);
+	m_invMass.reserve(count);
+	m_invMoment.reserve(count);
+	m_friction.reserve(count);
+	m_shape.reserve(count);
+	m_kinematic.reserve(count);
+	m_asleep.reserve(count);
+	m_sleepTime.reserve(count);
+	m_owners.reserve(count);
+	m_oldRows.reserve(count);
+	m_newRows.reserve(count);
+}
+
+void BodyStore::savePrevious()
+{
+	std::copy(m_positionX.begin(), m_positionX.end(), m_previousX.begin());
+	std::copy(m_positionY.begin(), m_positionY.end(), m_previousY.begin());
+	std::copy(m_rotation.begin(), m_rotation.end(), m_previousRotation.begin());
+}
+
+void BodyStore::integrate(const glm::vec2 gravity, const float timeStep)
+{
+	integrate(gravity, timeStep, 0, getCount());
+}
+
+void BodyStore::integrate(const glm::vec2 gravity, const float timeStep, const int begin, const int end)
+{
+	int i = begin;
+
+	// as many bodies as fit go through the widest kernel, the rest through
+	// the narrower ones
+#if defined(PHYSICS_SIMD_AVX2)
+	for (; i + 8 <= end; i += 8)
+	{
+		integrate8(gravity, timeStep, i);
+	}
+#endif
+#if defined(PHYSICS_SIMD_SSE2)
+	for (; i + 4 <= end; i += 4)
+	{
+		integrate4(gravity, timeStep, i);
+	}
+#endif
+	for (; i < end; i++)
+	{
+		integrateScalar(gravity, timeStep, i);
+	}
+}
+
+void BodyStore::integrateScalar(const glm::vec2 gravity, const float timeStep, const int i)
+{
+	if (!m_kinematic[i] && !m_asleep[i])
+	{
+		// remember when applying the force of gravity, mass cancels out
+		float vx = m_velocityX[i] + gravity.x * timeStep;
+		float vy = m_velocityY[i] + gravity.y * timeStep;
+		m_positionX[i] += vx * timeStep;
+		m_positionY[i] += vy * timeStep;
+
+		vx -= vx * m_friction[i] * timeStep;
+		vy -= vy * m_friction[i] * timeStep;
+		m_rotation[i] += m_angularVelocity[i] * timeStep;
+		float av = m_angularVelocity[i] - m_angularVelocity[i] * m_friction[i] * timeStep;
+
+		// compare squared speeds so there's no square root
+		if (vx * vx + vy * vy < MIN_LINEAR_THRESHOLD * MIN_LINEAR_THRESHOLD)
+		{
+			vx = 0;
+			vy = 0;
+		}
+		if (std::fabs(av) < MIN_ROTATION_THRESHOLD)
+		{
+			av = 0;
+		}
+
+		m_velocityX[i] = vx;
+		m_velocityY[i] = vy;
+		m_angularVelocity[i] = av;
+	}
+
+	m_rotationCos[i] = std::cos(m_rotation[i]);
+	m_rotationSin[i] = std::sin(m_rotation[i]);
+}
+
+void BodyStore::integrate(Body& body, const glm::vec2 gravity, const float timeStep)
+{
+	if (!body.kinematic && !body.asleep)
+	{
+		float vx = body.velocityX + gravity.x * timeStep;
+		float vy = body.velocityY + gravity.y * timeStep;
+		body.positionX += vx * timeStep;
+		body.positionY += vy * timeStep;
+
+		vx -= vx * body.friction * timeStep;
+		vy -= vy * body.friction * timeStep;
+		body.rotation += body.angularVelocity * timeStep;
+		float av = body.angularVelocity - body.angularVelocity * body.friction * timeStep;
+
+		if (vx * vx + vy * vy < MIN_LINEAR_THRESHOLD * MIN_LINEAR_THRESHOLD)
+		{
+			vx = 0;
+			vy = 0;
+		}
+		if (std::fabs(av) < MIN_ROTATION_THRESHOLD)
+		{
+			av = 0;
+		}
+
+		body.velocityX = vx;
+		body.velocityY = vy;
+		body.angularVelocity = av;
+	}
+
+	body.rotationCos = std::cos(body.rotation);
+	body.rotationSin = std::sin(body.rotation);
+}
+
+#if defined(PHYSICS_SIMD_SSE2)
+// the same as integrateScalar for the 4 bodies starting at i
+// kinematic bodies are worked out like the rest and then masked back to
+// their old values
+void BodyStore::integrate4(const glm::vec2 gravity, const float timeStep, const int i)
+{
+	const __m128 dt = _mm_set1_ps(timeStep);
+	const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32(0x80000000));
+
+	// expand the 4 kinematic and sleeping flags into a lane mask of the
+	// bodies that move
+	int flags, asleep;
+	std::memcpy(&flags, &m_kinematic[i], sizeof(flags));
+	std::memcpy(&asleep, &m_asleep[i], sizeof(asleep));
+	__m128i kinematic = _mm_cvtsi32_si128(flags | asleep);
+	kinematic = _mm_unpacklo_epi8(kinematic, _mm_setzero_si128());
+	kinematic = _mm_unpacklo_epi16(kinematic, _mm_setzero_si128());
+	__m128 dynamic = _mm_castsi128_ps(_mm_cmpeq_epi32(kinematic, _mm_setzero_si128()));
+
+	__m128 px = _mm_loadu_ps(&m_positionX[i]);
+	__m128 py = _mm_loadu_ps(&m_positionY[i]);
+	__m128 vx = _mm_loadu_ps(&m_velocityX[i]);
+	__m128 vy = _mm_loadu_ps(&m_velocityY[i]);
+	__m128 rotation = _mm_loadu_ps(&m_rotation[i]);
+	__m128 av = _mm_loadu_ps(&m_angularVelocity[i]);
+	__m128 friction = _mm_loadu_ps(&m_friction[i]);
+
+	__m128 newVx = _mm_add_ps(vx, _mm_set1_ps(gravity.x * timeStep));
+	__m128 newVy = _mm_add_ps(vy, _mm_set1_ps(gravity.y * timeStep));
+	__m128 newPx = _mm_add_ps(px, _mm_mul_ps(newVx, dt));
+	__m128 newPy = _mm_add_ps(py, _mm_mul_ps(newVy, dt));
+
+	newVx = _mm_sub_ps(newVx, _mm_mul_ps(_mm_mul_ps(newVx, friction), dt));
+	newVy = _mm_sub_ps(newVy, _mm_mul_ps(_mm_mul_ps(newVy, friction), dt));
+	__m128 newRotation = _mm_add_ps(rotation, _mm_mul_ps(av, dt));
+	__m128 newAv = _mm_sub_ps(av, _mm_mul_ps(_mm_mul_ps(av, friction), dt));
+
+	// snap slow bodies to a stop
+	__m128 speedSq = _mm_add_ps(_mm_mul_ps(newVx, newVx), _mm_mul_ps(newVy, newVy));
+	__m128 moving = _mm_cmpge_ps(speedSq, _mm_set1_ps(MIN_LINEAR_THRESHOLD * MIN_LINEAR_THRESHOLD));
+	newVx = _mm_and_ps(newVx, moving);
+	newVy = _mm_and_ps(newVy, moving);
+	__m128 spinning = _mm_cmpge_ps(_mm_andnot_ps(signMask, newAv), _mm_set1_ps(MIN_ROTATION_THRESHOLD));
+	newAv = _mm_and_ps(newAv, spinning);
+
+	// keep the old values for kinematic and sleeping bodies
+	px = _mm_or_ps(_mm_and_ps(dynamic, newPx), _mm_andnot_ps(dynamic, px));
+	py = _mm_or_ps(_mm_and_ps(dynamic, newPy), _mm_andnot_ps(dynamic, py));
+	vx = _mm_or_ps(_mm_and_ps(dynamic, newVx), _mm_andnot_ps(dynamic, vx));
+	vy = _mm_or_ps(_mm_and_ps(dynamic, newVy), _mm_andnot_ps(dynamic, vy));
+	rotation = _mm_or_ps(_mm_and_ps(dynamic, newRotation), _mm_andnot_ps(dynamic, rotation));
+	av = _mm_or_ps(_mm_and_ps(dynamic, newAv), _mm_andnot_ps(dynamic, av));
+
+	_mm_storeu_ps(&m_positionX[i], px);
+	_mm_storeu_ps(&m_positionY[i], py);
+	_mm_storeu_ps(&m_velocityX[i], vx);
+	_mm_storeu_ps(&m_velocityY[i], vy);
+	_mm_storeu_ps(&m_rotation[i], rotation);
+	_mm_storeu_ps(&m_angularVelocity[i], av);
+
+	__m128 s, c;
+	SimdMath::sincos4(rotation, s, c);
+	_mm_storeu_ps(&m_rotationSin[i], s);
+	_mm_storeu_ps(&m_rotationCos[i], c);
+
+	// bodies that have spun too far for the polynomial get the slow path
+	__m128 tooBig = _mm_cmpgt_ps(_mm_andnot_ps(signMask, rotation), _mm_set1_ps(SimdMath::SINCOS_MAX_INPUT));
+	if (_mm_movemask_ps(tooBig) != 0)
+	{
+		for (int j = i; j < i + 4; j++)
+		{
+			m_rotationCos[j] = std::cos(m_rotation[j]);
+			m_rotationSin[j] = std::sin(m_rotation[j]);
+		}
+	}
+}
+#endif
+
+#if defined(PHYSICS_SIMD_AVX2)
+// the same as integrate4 for the 8 bodies starting at i
+void BodyStore::integrate8(const glm::vec2 gravity, const float timeStep, const int i)
+{
+	const __m256 dt = _mm256_set1_ps(timeStep);
+	const __m256 signMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x80000000));
+
+	// expand the 8 kinematic and sleeping flags into a lane mask of the
+	// bodies that move
+	__m256i kinematic = _mm256_cvtepu8_epi32(_mm_or_si128(_mm_loadl_epi64((const __m128i*)&m_kinematic[i]),
+		_mm_loadl_epi64((const __m128i*)&m_asleep[i])));
+	__m256 dynamic = _mm256_castsi256_ps(_mm256_cmpeq_epi32(kinematic, _mm256_setzero_si256()));
+
+	__m256 px = _mm256_loadu_ps(&m_positionX[i]);
+	__m256 py = _mm256_loadu_ps(&m_positionY[i]);
+	__m256 vx = _mm256_loadu_ps(&m_velocityX[i]);
+	__m256 vy = _mm256_loadu_ps(&m_velocityY[i]);
+	__m256 rotation = _mm256_loadu_ps(&m_rotation[i]);
+	__m256 av = _mm256_loadu_ps(&m_angularVelocity[i]);
+	__m256 friction = _mm256_loadu_ps(&m_friction[i]);
+
+	__m256 newVx = _mm256_add_ps(vx, _mm256_set1_ps(gravity.x * timeStep));
+	__m256 newVy = _mm256_add_ps(vy, _mm256_set1_ps(gravity.y * timeStep));
+	__m256 newPx = _mm256_add_ps(px, _mm256_mul_ps(newVx, dt));
+	__m256 newPy = _mm256_add_ps(py, _mm256_mul_ps(newVy, dt));
+
+	newVx = _mm256_sub_ps(newVx, _mm256_mul_ps(_mm256_mul_ps(newVx, friction), dt));
+	newVy = _mm256_sub_ps(newVy, _mm256_mul_ps(_mm256_mul_ps(newVy, friction), dt));
+	__m256 newRotation = _mm256_add_ps(rotation, _mm256_mul_ps(av, dt));
+	__m256 newAv = _mm256_sub_ps(av, _mm256_mul_ps(_mm256_mul_ps(av, friction), dt));
+
+	// snap slow bodies to a stop
+	__m256 speedSq = _mm256_add_ps(_mm256_mul_ps(newVx, newVx), _mm256_mul_ps(newVy, newVy));
+	__m256 moving = _mm256_cmp_ps(speedSq, _mm256_set1_ps(MIN_LINEAR_THRESHOLD * MIN_LINEAR_THRESHOLD), _CMP_GE_OQ);
+	newVx = _mm256_and_ps(newVx, moving);
+	newVy = _mm256_and_ps(newVy, moving);
+	__m256 spinning = _mm256_cmp_ps(_mm256_andnot_ps(signMask, newAv), _mm256_set1_ps(MIN_ROTATION_THRESHOLD), _CMP_GE_OQ);
+	newAv = _mm256_and_ps(newAv, spinning);
+
+	// keep the old values for kinematic and sleeping bodies
+	px = _mm256_blendv_ps(px, newPx, dynamic);
+	py = _mm256_blendv_ps(py, newPy, dynamic);
+	vx = _mm256_blendv_ps(vx, newVx, dynamic);
+	vy = _mm256_blendv_ps(vy, newVy, dynamic);
+	rotation = _mm256_blendv_ps(rotation, newRotation, dynamic);
+	av = _mm256_blendv_ps(av, newAv, dynamic);
+
+	_mm256_storeu_ps(&m_positionX[i], px);
+	_mm256_storeu_ps(&m_positionY[i], py);
+	_mm256_storeu_ps(&m_velocityX[i], vx);
+	_mm256_storeu_ps(&m_velocityY[i], vy);
+	_mm256_storeu_ps(&m_rotation[i], rotation);
+	_mm256_storeu_ps(&m_angularVelocity[i], av);
+
+	__m256 s, c;
+	SimdMath::sincos8(rotation, s, c);
+	_mm256_storeu_ps(&m_rotationSin[i], s);
+	_mm256_storeu_ps(&m_rotationCos[i], c);
+
+	// bodies that have spun too far for the polynomial get the slow path
+	__m256 tooBig = _mm256_cmp_ps(_mm256_andnot_ps(signMask, rotation), _mm256_set1_ps(SimdMath::SINCOS_MAX_INPUT), _CMP_GT_OQ);
+	if (_mm256_movemask_ps(tooBig) != 0)
+	{
+		for (int j = i; j < i + 8; j++)
+		{
+			m_rotationCos[j] = std::cos(m_rotation[j]);
+			m_rotationSin[j] = std::sin(m_rotation[j]);
+		}
+	}
+}
+#endif
+
+int BodyStore::add(RigidBody* owner, const Body& body)
+{
+	m_positionX.push_back(body.positionX);
+	m_positionY.push_back(body.positionY);
+	m_velocityX.push_back(body.velocityX);
+	m_velocityY.push_back(body.velocityY);
+	m_rotation.push_back(body.rotation);
+	m_rotationCos.push_back(body.rotationCos);
+	m_rotationSin.push_back(body.rotationSin);
+	m_angularVelocity.push_back(body.angularVelocity);
+	m_previousX.push_back(body.previousX);
+	m_previousY.push_back(body.previousY);
+	m_previousRotation.push_back(body.previousRotation);
+	m_invMass.push_back(body.invMass);
+	m_invMoment.push_back(body.invMoment);
+	m_friction.push_back(body.friction);
+	m_shape.push_back(body.shape);
+	m_kinematic.push_back(body.kinematic);
+	m_asleep.push_back(body.asleep);
+	m_sleepTime.push_back(body.sleepTime);
+	m_owners.push_back(owner);
+	m_oldRows.push_back(-1);
+	m_rowsChanged = true;
+
+	return getCount() - 1;
+}
+
+// swaps the last body into the removed slot to keep the arrays packed
+void BodyStore::remove(const int index)
+{
+	RigidBody* owner = m_owners[index];
+	if (owner->m_movedIndex >= 0)
+	{
+		m_moved[owner->m_movedIndex] = m_moved.back();
+		m_moved[owner->m_movedIndex]->m_movedIndex = owner->m_movedIndex;
+		m_moved.pop_back();
+		owner->m_movedIndex = -1;
+	}
+
+	if (m_oldRows[index] >= 0)
+	{
+		m_newRows[m_oldRows[index]] = -1;
+	}
+	m_rowsChanged = true;
+
+	int last = getCount() - 1;
+	if (index != last)
+	{
+		m_positionX[index] = m_positionX[last];
+		m_positionY[index] = m_positionY[last];
+		m_velocityX[index] = m_velocityX[last];
+		m_velocityY[index] = m_velocityY[last];
+		m_rotation[index] = m_rotation[last];
+		m_rotationCos[index] = m_rotationCos[last];
+		m_rotationSin[index] = m_rotationSin[last];
+		m_angularVelocity[index] = m_angularVelocity[last];
+		m_previousX[index] = m_previousX[last];
+		m_previousY[index] = m_previousY[last];
+		m_previousRotation[index] = m_previousRotation[last];
+		m_invMass[index] = m_invMass[last];
+		m_invMoment[index] = m_invMoment[last];
+		m_friction[index] = m_friction[last];
+		m_shape[index] = m_shape[last];
+		m_kinematic[index] = m_kinematic[last];
+		m_asleep[index] = m_asleep[last];
+		m_sleepTime[index] = m_sleepTime[last];
+		m_owners[index] = m_owners[last];
+		m_owners[index]->m_index = index;
+
+		m_oldRows[index] = m_oldRows[last];
+		if (m_oldRows[index] >= 0)
+		{
+			m_newRows[m_oldRows[index]] = index;
+		}
+	}
+
+	m_positionX.pop_back();
+	m_positionY.pop_back();
+	m_velocityX.pop_back();
+	m_velocityY.pop_back();
+	m_rotation.pop_back();
+	m_rotationCos.pop_back();
+	m_rotationSin.pop_back();
+	m_angularVelocity.pop_back();
+	m_previousX.pop_back();
+	m_previousY.pop_back();
+	m_previousRotation.pop_back();
+	m_invMass.pop_back();
+	m_invMoment.pop_back();
+	m_friction.pop_back();
+	m_shape.pop_back();
+	m_kinematic.pop_back();
+	m_asleep.pop_back();
+	m_sleepTime.pop_back();
+	m_owners.pop_back();
+	m_oldRows.pop_back();
+}
+
+void BodyStore::commitRows()
+{
+	int count = getCount();
+	m_newRows.resize(count);
+	for (int i = 0; i < count; i++)
+	{
+		m_oldRows[i] = i;
+		m_newRows[i] = i;
+	}
+	m_rowsChanged = false;
+}
+
+void BodyStore::clearMoved()
+{
+	for (auto body : m_moved)
+	{
+		body->m_movedIndex = -1;
+	}
+	m_moved.clear();
+}
+
+void BodyStore::read(const int index, Body& body) const
+{
+	body.positionX = m_positionX[index];
+	body.positionY = m_positionY[index];
+	body.velocityX = m_velocityX[index];
+	body.velocityY = m_velocityY[index];
+	body.rotation = m_rotation[index];
+	body.rotationCos = m_rotationCos[index];
+	body.rotationSin = m_rotationSin[index];
+	body.angularVelocity = m_angularVelocity[index];
+	body.previousX = m_previousX[index];
+	body.previousY = m_previousY[index];
+	body.previousRotation = m_previousRotation[index];
+	body.invMass = m_invMass[index];
+	body.invMoment = m_invMoment[index];
+	body.friction = m_friction[index];
+	body.shape = m_shape[index];
+	body.kinematic = m_kinematic[index];
+	body.asleep = m_asleep[index];
+	body.sleepTime = m_sleepTime[index];
+}
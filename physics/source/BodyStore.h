@@ -0,0 +1,137 @@
+#pragma once
+#include <glm/vec2.hpp>
+#include <vector>
+#include <cstdint>
+#include "PhysicsObject.h"
+
+class RigidBody;
+
+// structure of arrays storage for the simulation state of rigid bodies
+// a RigidBody in a scene is a thin handle holding an index into the
+// scene's store, so integrating them streams through contiguous arrays
+// rather than chasing pointers. a body that isn't in a scene keeps its
+// state to itself in a Body, so bodies can be built on any thread
+class BodyStore
+{
+public:
+	BodyStore() {};
+	~BodyStore() {};
+
+	BodyStore(const BodyStore&) = delete;
+	BodyStore& operator=(const BodyStore&) = delete;
+
+	// one body's state, a row of the arrays below
+	struct Body
+	{
+		float positionX = 0;
+		float positionY = 0;
+		float velocityX = 0;
+		float velocityY = 0;
+		float rotation = 0;
+		float rotationCos = 1;
+		float rotationSin = 0;
+		float angularVelocity = 0;
+		float previousX = 0;
+		float previousY = 0;
+		float previousRotation = 0;
+		float invMass = 1;
+		float invMoment = 0;
+		float friction = 0;
+		uint8_t shape = 0;
+		uint8_t kinematic = 0;
+		uint8_t asleep = 0;
+		float sleepTime = 0;
+	};
+
+	int getCount() const { return (int)m_owners.size(); }
+	RigidBody* getOwner(const int index) const { return m_owners[index]; }
+
+	// reserve room for this many bodies
+	void reserve(const int count);
+
+	// integrates every body in the store, or the bodies in [begin, end)
+	// runs 8 (AVX2) or 4 (SSE2) bodies at a time where it can. kinematic
+	// and sleeping bodies are left alone
+	void integrate(const glm::vec2 gravity, const float timeStep);
+	void integrate(const glm::vec2 gravity, const float timeStep, const int begin, const int end);
+
+	// integrates a body that isn't in a store the same way
+	static void integrate(Body& body, const glm::vec2 gravity, const float timeStep);
+
+	// velocities below these are snapped to zero
+	static constexpr float MIN_LINEAR_THRESHOLD = 0.01f;
+	static constexpr float MIN_ROTATION_THRESHOLD = 0.1f;
+
+	// copies every body's position and rotation before a step moves them,
+	// drawing blends between these and the current ones
+	void savePrevious();
+
+	// removing bodies moves others into the gaps. the store remembers
+	// which row each body had at the last commitRows, so what refers to the
+	// old rows can be fixed up in one go rather than on every removal
+	bool haveRowsChanged() const { return m_rowsChanged; }
+	// where the body in an old row is now, -1 if it was removed
+	int getNewRow(const int oldRow) const { return m_newRows[oldRow]; }
+	void commitRows();
+
+protected:
+
+	friend class RigidBody;
+	friend class ContactSolver;
+	friend class PhysicsScene;
+
+	// adds a body with this state and returns its index
+	int add(RigidBody* owner, const Body& body);
+	void remove(const int index);
+
+	// copies a body's state out of the store
+	void read(const int index, Body& body) const;
+
+	// integration kernels for one body, and for 4 and 8 bodies starting at i
+	void integrateScalar(const glm::vec2 gravity, const float timeStep, const int i);
+	void integrate4(const glm::vec2 gravity, const float timeStep, const int i);
+	void integrate8(const glm::vec2 gravity, const float timeStep, const int i);
+
+	// linear
+	std::vector<float> m_positionX;
+	std::vector<float> m_positionY;
+	std::vector<float> m_velocityX;
+	std::vector<float> m_velocityY;
+
+	// angular, with the rotation's cosine and sine cached for the shapes
+	std::vector<float> m_rotation;
+	std::vector<float> m_rotationCos;
+	std::vector<float> m_rotationSin;
+	std::vector<float> m_angularVelocity;
+
+	// where each body was before the last step
+	std::vector<float> m_previousX;
+	std::vector<float> m_previousY;
+	std::vector<float> m_previousRotation;
+
+	std::vector<float> m_invMass;
+	std::vector<float> m_invMoment;
+	std::vector<float> m_friction;
+
+	std::vector<uint8_t> m_shape;
+	std::vector<uint8_t> m_kinematic;
+
+	// sleeping bodies aren't integrated, and the sleep time is how long
+	// a body has been slow enough to fall asleep
+	std::vector<uint8_t> m_asleep;
+	std::vector<float> m_sleepTime;
+
+	std::vector<RigidBody*> m_owners;
+
+	// kinematic bodies moved with setPosition or setRotation since the
+	// last step, the scene wakes whatever they were resting against. each
+	// body knows where it is in here so it comes out in constant time
+	std::vector<RigidBody*> m_moved;
+	void clearMoved();
+
+	// the old row of each body, -1 for bodies added since the last commit,
+	// and the new row of each old one
+	std::vector<int> m_oldRows;
+	std::vector<int> m_newRows;
+	bool m_rowsChanged = false;
+};
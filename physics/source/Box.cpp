@@ -0,0 +1,100 @@
+#include "Box.h"
+#include <glm/ext.hpp>
+#include <iostream>
+
+Box::Box() :
+	RigidBody(BOX)
+{
+	
+}
+
+// check if any of the other box's corners are inside this box
+bool Box::checkBoxCorners(const Box& box, glm::vec2& contact, int& numContacts,
+	glm::vec2& edgeNormal, glm::vec2& contactForce)
+{
+	float boxW = box.getExtents().x * 2;
+	float boxH = box.getExtents().y * 2;
+	float penetration = 0;
+
+	glm::vec2 position = getPosition();
+	glm::vec2 localX = getLocalX();
+	glm::vec2 localY = getLocalY();
+
+	glm::vec2 boxPosition = box.getPosition();
+	glm::vec2 boxLocalX = box.getLocalX();
+	glm::vec2 boxLocalY = box.getLocalY();
+
+	for (float x = -box.getExtents().x; x < boxW; x += boxW)
+	{
+		for (float y = -box.getExtents().y; y < boxH; y += boxH)
+		{
+			// pos in worldspace
+			glm::vec2 p = boxPosition + x * boxLocalX + y * boxLocalY;
+
+			// position in our box's space
+			glm::vec2 p0(glm::dot(p - position, localX),
+				glm::dot(p - position, localY));
+
+			float w2 = m_extents.x, h2 = m_extents.y;
+			if (p0.y < h2 && p0.y > -h2)
+			{
+				if (p0.x > 0 && p0.x < w2)
+				{
+					numContacts++;
+					contact += position + w2 * localX + p0.y * localY;
+					edgeNormal = localX;
+					penetration = w2 - p0.x;
+				}
+				if (p0.x < 0 && p0.x > -w2)
+				{
+					numContacts++;
+					contact += position - w2 * localX + p0.y * localY;
+					edgeNormal = -localX;
+					penetration = w2 + p0.x;
+				}
+			}
+			if (p0.x < w2 && p0.x > -w2)
+			{
+				if (p0.y > 0 && p0.y < h2)
+				{
+					numContacts++;
+					contact += position + p0.x * localX + h2 * localY;
+					float pen0 = h2 - p0.y;
+					if (pen0 < penetration || penetration == 0)
+					{
+						penetration = pen0;
+						edgeNormal = localY;
+					}
+				}
+				if (p0.y < 0 && p0.y > -h2)
+				{
+					numContacts++;
+					contact += position + p0.x * localX - h2 * localY;
+					float pen0 = h2 + p0.y;
+					if (pen0 < penetration || penetration == 0)
+					{
+						penetration = pen0;
+						edgeNormal = -localY;
+					}
+				}
+			}
+		}
+	}
+	contactForce = penetration * edgeNormal;
+	return (penetration != 0);
+}
+
+void Box::calculateBounds()
+{
+	// project the rotated half extents onto the world axes
+	glm::vec2 position = getPosition();
+	glm::vec2 extents = glm::abs(getLocalX()) * m_extents.x + glm::abs(getLocalY()) * m_extents.y;
+	m_boundsMin = position - extents;
+	m_boundsMax = position + extents;
+}
+
+// calculate moment of inertia
+void Box::calculateMoment()
+{
+	setMoment(1.0f / 12.0f * m_mass * (m_extents.x * 2) * (m_extents.y * 2));
+}
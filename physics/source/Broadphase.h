@@ -0,0 +1,33 @@
+#pragma once
+#include <vector>
+#include "PhysicsObject.h"
+
+// a pair of actors whose bounds are close enough to need a narrowphase test
+struct CollisionPair
+{
+	PhysicsObject* a;
+	PhysicsObject* b;
+};
+
+// pairs of static, kinematic or sleeping actors never need testing against
+// each other, at least one of them has to be active
+inline bool canCollide(const PhysicsObject* a, const PhysicsObject* b)
+{
+	return a->isActive() || b->isActive();
+}
+
+// base class for the broadphase strategies a PhysicsScene can use to
+// cut down the number of pairs handed to the collision functions
+class Broadphase
+{
+public:
+	virtual ~Broadphase() {};
+
+	// called by the scene as actors are added and removed, for
+	// broadphases that keep their own state between steps
+	virtual void addActor(PhysicsObject*) {}
+	virtual void removeActor(PhysicsObject*) {}
+
+	// fills pairs with every potentially colliding pair of actors
+	virtual void findPairs(const std::vector<PhysicsObject*>& actors, std::vector<CollisionPair>& pairs) = 0;
+};
@@ -0,0 +1,125 @@
+#pragma once
+#include "PhysicsObject.h"
+#include "Contact.h"
+#include <array>
+#include <type_traits>
+#include <utility>
+
+class Plane;
+class Sphere;
+class Aabb;
+class Box;
+
+// function pointer type stored in the collision dispatch table
+// returns true and fills in the contact when the objects are touching
+typedef bool(*CollisionFunction)(PhysicsObject*, PhysicsObject*, Contact&);
+
+// the class behind each ShapeTypes value
+// a new shape needs an entry here as well as its collision handlers
+template<int Shape> struct ShapeClass;
+template<> struct ShapeClass<PLANE> { typedef Plane type; };
+template<> struct ShapeClass<SPHERE> { typedef Sphere type; };
+template<> struct ShapeClass<AABB> { typedef Aabb type; };
+template<> struct ShapeClass<BOX> { typedef Box type; };
+
+// wraps a typed collision function for the shapes A and B
+// the dispatch table only stores PhysicsObject pointers, and the table
+// index already guarantees the types so a static_cast is enough
+template<class A, class B, bool(*Function)(A*, B*, Contact&)>
+struct CollisionHandler
+{
+	static bool forward(PhysicsObject* a, PhysicsObject* b, Contact& contact)
+	{
+		return Function(static_cast<A*>(a), static_cast<B*>(b), contact);
+	}
+
+	// the same test with the objects the other way round, the contact
+	// still comes out with the A shape as body a
+	static bool reverse(PhysicsObject* a, PhysicsObject* b, Contact& contact)
+	{
+		return Function(static_cast<A*>(b), static_cast<B*>(a), contact);
+	}
+
+	// whether this handler covers the (X, Y) slot. the table is built
+	// from this rather than by comparing function pointers, which not
+	// every compiler accepts in a constant expression
+	template<class X, class Y>
+	static constexpr bool covers()
+	{
+		return (std::is_same<X, A>::value && std::is_same<Y, B>::value) ||
+			(std::is_same<X, B>::value && std::is_same<Y, A>::value);
+	}
+
+	// returns the entry this handler provides for the (X, Y) slot
+	template<class X, class Y>
+	static constexpr CollisionFunction entry()
+	{
+		return std::is_same<X, A>::value && std::is_same<Y, B>::value ? &forward :
+			std::is_same<X, B>::value && std::is_same<Y, A>::value ? &reverse : nullptr;
+	}
+};
+
+// finds the first handler that covers the (X, Y) slot
+template<class X, class Y, class... Handlers>
+struct FindCollisionHandler
+{
+	static constexpr bool found() { return false; }
+	static constexpr CollisionFunction get() { return nullptr; }
+};
+
+template<class X, class Y, class Handler, class... Rest>
+struct FindCollisionHandler<X, Y, Handler, Rest...>
+{
+	static constexpr bool found()
+	{
+		return Handler::template covers<X, Y>() || FindCollisionHandler<X, Y, Rest...>::found();
+	}
+
+	static constexpr CollisionFunction get()
+	{
+		return Handler::template covers<X, Y>() ?
+			Handler::template entry<X, Y>() : FindCollisionHandler<X, Y, Rest...>::get();
+	}
+};
+
+// a list of collision handlers, used to build the dispatch table
+template<class... Handlers>
+struct CollisionHandlerList
+{
+	typedef std::array<CollisionFunction, SHAPECOUNT * SHAPECOUNT> Table;
+	typedef std::array<bool, SHAPECOUNT * SHAPECOUNT> Coverage;
+
+	// builds the SHAPECOUNT x SHAPECOUNT table, indexed by
+	// (shapeId1 * SHAPECOUNT) + shapeId2. slots no handler covers are nullptr
+	static constexpr Table makeTable()
+	{
+		return makeTable(std::make_index_sequence<SHAPECOUNT * SHAPECOUNT>());
+	}
+
+	// which slots of the table have a handler, for checking it at
+	// compile time
+	static constexpr Coverage makeCoverage()
+	{
+		return makeCoverage(std::make_index_sequence<SHAPECOUNT * SHAPECOUNT>());
+	}
+
+private:
+
+	template<std::size_t... Index>
+	static constexpr Coverage makeCoverage(std::index_sequence<Index...>)
+	{
+		return Coverage{ { FindCollisionHandler<
+			typename ShapeClass<Index / SHAPECOUNT>::type,
+			typename ShapeClass<Index % SHAPECOUNT>::type,
+			Handlers...>::found()... } };
+	}
+
+	template<std::size_t... Index>
+	static constexpr Table makeTable(std::index_sequence<Index...>)
+	{
+		return Table{ { FindCollisionHandler<
+			typename ShapeClass<Index / SHAPECOUNT>::type,
+			typename ShapeClass<Index % SHAPECOUNT>::type,
+			Handlers...>::get()... } };
+	}
+};
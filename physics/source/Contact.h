@@ -0,0 +1,28 @@
+#pragma once
+#include <glm/vec2.hpp>
+#include <cstdint>
+
+// what the narrowphase found out about one touching pair of bodies
+// the collision functions fill these in and the response pass uses them
+// afterwards, so detecting a collision never moves anything
+struct Contact
+{
+	// indices into the scene's BodyStore, only valid for the step the
+	// contact was found in
+	int bodyA;
+	int bodyB;
+
+	// unit normal pointing from a towards b
+	glm::vec2 normal;
+
+	// up to two world space contact points
+	glm::vec2 points[2];
+	int pointCount;
+
+	// how far the shapes overlap along the normal
+	float penetration;
+
+	// which corners and edges touched, so a contact can be matched up
+	// with the same one in the next step
+	uint32_t featureId;
+};
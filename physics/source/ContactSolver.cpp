@@ -0,0 +1,876 @@
+#include "ContactSolver.h"
+#include "BodyStore.h"
+#include "RigidBody.h"
+#include "Profiler.h"
+#include "ThreadPool.h"
+#include "UnionFind.h"
+#include <algorithm>
+#include <cmath>
+
+// std::min takes this by reference, which needs a definition before C++17
+constexpr int ContactSolver::MAX_COLORS;
+
+void ContactSolver::solve(BodyStore& store, const std::vector<Contact>& contacts, UnionFind& islands,
+	ThreadPool* threadPool)
+{
+	m_store = &store;
+	m_threadPool = threadPool;
+
+	prepare(store, contacts, islands);
+	groupIslands(store.getCount());
+
+	// the giant islands are at the front, each is spread over the pool
+	for (int i = 0; i < m_giantIslandCount; i++)
+	{
+		solveColoredIsland(m_islandRanges[i]);
+	}
+
+	// then the rest are handed out an island at a time
+	int islandCount = (int)m_islandRanges.size() - m_giantIslandCount;
+	if (m_threadPool != nullptr)
+	{
+		m_threadPool->parallelFor(islandCount, &ContactSolver::solveIslandTask, this);
+	}
+	else
+	{
+		for (int i = 0; i < islandCount; i++)
+		{
+			solveIsland(m_islandRanges[m_giantIslandCount + i]);
+		}
+	}
+
+	updateCache();
+}
+
+void ContactSolver::solveIsland(const IslandRange& island)
+{
+	if (m_warmStarting)
+	{
+		warmStart(island.begin, island.end);
+	}
+
+	if (island.colorCount == 0)
+	{
+		for (int i = 0; i < m_iterations; i++)
+		{
+			solveVelocities(island.begin, island.end);
+		}
+	}
+	else
+	{
+		packBatches(island);
+
+		for (int i = 0; i < m_iterations; i++)
+		{
+			for (int color = 0; color < island.colorCount; color++)
+			{
+				int offset = island.firstColor + color;
+
+				// the last colour can have points sharing bodies
+				if (color == MAX_COLORS)
+				{
+					solveVelocities(m_colorOffsets[offset], m_colorOffsets[offset + 1]);
+				}
+				else
+				{
+					solveBatches(m_batchOffsets[offset], m_batchOffsets[offset + 1]);
+				}
+			}
+		}
+
+		unpackBatches(island);
+	}
+
+	// the penetration is fixed by moving the bodies rather than by adding
+	// velocity, so overlapping bodies don't fly apart
+	for (int i = 0; i < m_positionIterations; i++)
+	{
+		solvePositions(island.begin, island.end);
+	}
+}
+
+void ContactSolver::solveIslandTask(void* solver, int index)
+{
+	PROFILE_ZONE("solveIsland");
+	ContactSolver* contactSolver = (ContactSolver*)solver;
+	contactSolver->solveIsland(contactSolver->m_islandRanges[contactSolver->m_giantIslandCount + index]);
+}
+
+void ContactSolver::solveColoredIsland(const IslandRange& island)
+{
+	if (m_warmStarting)
+	{
+		warmStart(island.begin, island.end);
+	}
+
+	packBatches(island);
+
+	int iterations = m_iterations + m_positionIterations;
+	for (int i = 0; i < iterations; i++)
+	{
+		m_solvingPositions = i >= m_iterations;
+		if (i == m_iterations)
+		{
+			unpackBatches(island);
+		}
+
+		for (int color = 0; color < island.colorCount; color++)
+		{
+			int offset = island.firstColor + color;
+			m_colorBegin = m_colorOffsets[offset];
+			m_colorEnd = m_colorOffsets[offset + 1];
+			m_batchBegin = m_batchOffsets[offset];
+			m_batchEnd = m_batchOffsets[offset + 1];
+
+			// the last colour can have points sharing bodies
+			bool overflow = color == MAX_COLORS;
+			int taskCount = (m_colorEnd - m_colorBegin + POINTS_PER_TASK - 1) / POINTS_PER_TASK;
+
+			if (m_threadPool != nullptr && !overflow && taskCount > 1)
+			{
+				m_threadPool->parallelFor(taskCount, &ContactSolver::solveColorTask, this);
+			}
+			else if (m_solvingPositions)
+			{
+				solvePositions(m_colorBegin, m_colorEnd);
+			}
+			else if (overflow)
+			{
+				solveVelocities(m_colorBegin, m_colorEnd);
+			}
+			else
+			{
+				solveBatches(m_batchBegin, m_batchEnd);
+			}
+		}
+	}
+}
+
+void ContactSolver::solveColorTask(void* solver, int index)
+{
+	PROFILE_ZONE("solveColor");
+	ContactSolver* contactSolver = (ContactSolver*)solver;
+
+	if (contactSolver->m_solvingPositions)
+	{
+		int begin = contactSolver->m_colorBegin + index * POINTS_PER_TASK;
+		int end = std::min(begin + POINTS_PER_TASK, contactSolver->m_colorEnd);
+		contactSolver->solvePositions(begin, end);
+	}
+	else
+	{
+		int batchesPerTask = POINTS_PER_TASK / BATCH_WIDTH;
+		int begin = contactSolver->m_batchBegin + index * batchesPerTask;
+		int end = std::min(begin + batchesPerTask, contactSolver->m_batchEnd);
+		contactSolver->solveBatches(begin, end);
+	}
+}
+
+// works out everything about each contact point that stays the same over
+// the iterations
+void ContactSolver::prepare(BodyStore& store, const std::vector<Contact>& contacts, UnionFind& islands)
+{
+	PROFILE_ZONE("prepareContacts");
+	m_points.clear();
+
+	// everything else the solver keeps per point is sized off this, so
+	// as long as the contacts fit nothing has to grow. it doubles like
+	// push_back would so a slowly growing pile doesn't grow it every step
+	if (m_points.capacity() < contacts.size() * 2)
+	{
+		m_points.reserve(std::max(contacts.size() * 2, m_points.capacity() * 2));
+	}
+
+	for (auto& contact : contacts)
+	{
+		int a = contact.bodyA;
+		int b = contact.bodyB;
+
+		// kinematic bodies can't be pushed around at all
+		float invMassA = store.m_kinematic[a] ? 0.0f : store.m_invMass[a];
+		float invMassB = store.m_kinematic[b] ? 0.0f : store.m_invMass[b];
+		float invMomentA = store.m_kinematic[a] ? 0.0f : store.m_invMoment[a];
+		float invMomentB = store.m_kinematic[b] ? 0.0f : store.m_invMoment[b];
+
+		glm::vec2 positionA(store.m_positionX[a], store.m_positionY[a]);
+		glm::vec2 positionB(store.m_positionX[b], store.m_positionY[b]);
+		glm::vec2 tangent(contact.normal.y, -contact.normal.x);
+
+		float elasticity = (store.m_owners[a]->getElasticity() + store.m_owners[b]->getElasticity()) / 2.0f;
+		float friction = std::sqrt(store.m_friction[a] * store.m_friction[b]);
+
+		for (int i = 0; i < contact.pointCount; i++)
+		{
+			SolverPoint point;
+			point.bodyA = a;
+			point.bodyB = b;
+			point.normal = contact.normal;
+			point.rA = contact.points[i] - positionA;
+			point.rB = contact.points[i] - positionB;
+
+			// the effective mass along the normal and the tangent
+			float rnA = point.rA.x * contact.normal.y - point.rA.y * contact.normal.x;
+			float rnB = point.rB.x * contact.normal.y - point.rB.y * contact.normal.x;
+			float normalMass = invMassA + invMassB + invMomentA * rnA * rnA + invMomentB * rnB * rnB;
+			point.normalMass = normalMass > 0 ? 1.0f / normalMass : 0.0f;
+
+			float rtA = point.rA.x * tangent.y - point.rA.y * tangent.x;
+			float rtB = point.rB.x * tangent.y - point.rB.y * tangent.x;
+			float tangentMass = invMassA + invMassB + invMomentA * rtA * rtA + invMomentB * rtB * rtB;
+			point.tangentMass = tangentMass > 0 ? 1.0f / tangentMass : 0.0f;
+
+			// bounce off fast contacts
+			glm::vec2 velocityA(store.m_velocityX[a] - store.m_angularVelocity[a] * point.rA.y,
+				store.m_velocityY[a] + store.m_angularVelocity[a] * point.rA.x);
+			glm::vec2 velocityB(store.m_velocityX[b] - store.m_angularVelocity[b] * point.rB.y,
+				store.m_velocityY[b] + store.m_angularVelocity[b] * point.rB.x);
+			float normalVelocity = glm::dot(velocityB - velocityA, contact.normal);
+
+			point.bias = 0;
+			if (normalVelocity < -RESTITUTION_THRESHOLD)
+			{
+				point.bias = -elasticity * normalVelocity;
+			}
+
+			point.separation = -contact.penetration;
+			point.invMassA = invMassA;
+			point.invMassB = invMassB;
+			point.startA = positionA;
+			point.startB = positionB;
+
+			point.friction = friction;
+			point.normalImpulse = 0;
+			point.tangentImpulse = 0;
+
+			point.key = ((uint64_t)a << 32) | (uint32_t)b;
+			point.featureId = contact.featureId;
+			point.point = i;
+
+			// kinematic bodies aren't part of any island
+			point.island = islands.find(store.m_kinematic[a] ? b : a);
+			point.color = 0;
+
+			m_points.push_back(point);
+		}
+	}
+}
+
+void ContactSolver::groupIslands(const int bodyCount)
+{
+	// give each island a dense id in the order they first turn up, and
+	// count their points
+	m_islandIds.assign(bodyCount, -1);
+	m_islandRanges.clear();
+	m_islandRanges.reserve(m_points.capacity());
+
+	for (auto& point : m_points)
+	{
+		if (m_islandIds[point.island] < 0)
+		{
+			m_islandIds[point.island] = (int)m_islandRanges.size();
+			m_islandRanges.push_back({ 0, 0, 0, 0 });
+		}
+		point.island = m_islandIds[point.island];
+		m_islandRanges[point.island].end++;
+	}
+
+	// turn the counts into ranges, then move the points into place
+	int begin = 0;
+	for (auto& island : m_islandRanges)
+	{
+		int count = island.end;
+		island.begin = begin;
+		island.end = begin;
+		begin += count;
+	}
+
+	m_sortedPoints.reserve(m_points.capacity());
+	m_sortedPoints.resize(m_points.size());
+	for (auto& point : m_points)
+	{
+		m_sortedPoints[m_islandRanges[point.island].end++] = point;
+	}
+	m_points.swap(m_sortedPoints);
+
+	std::sort(m_islandRanges.begin(), m_islandRanges.end());
+
+	// the biggest islands are at the front, colour all the ones big enough
+	// to fill some batches
+	m_giantIslandCount = 0;
+	m_colorOffsets.clear();
+	m_batchOffsets.clear();
+	m_colorOffsets.reserve((m_points.capacity() / BATCH_ISLAND_POINTS) * (MAX_COLORS + 2));
+	m_batchOffsets.reserve(m_colorOffsets.capacity());
+	m_bodyColors.resize(bodyCount);
+	for (auto& island : m_islandRanges)
+	{
+		int pointCount = island.end - island.begin;
+		if (pointCount < BATCH_ISLAND_POINTS)
+		{
+			break;
+		}
+
+		colorIsland(island);
+		if (pointCount > GIANT_ISLAND_POINTS)
+		{
+			m_giantIslandCount++;
+		}
+	}
+	m_batches.resize(m_batchOffsets.empty() ? 0 : m_batchOffsets.back());
+}
+
+// greedy colouring, each point gets the lowest colour neither of its bodies
+// has been given yet. kinematic bodies are only read so they don't count
+void ContactSolver::colorIsland(IslandRange& island)
+{
+	for (int i = island.begin; i < island.end; i++)
+	{
+		m_bodyColors[m_points[i].bodyA] = 0;
+		m_bodyColors[m_points[i].bodyB] = 0;
+	}
+
+	int counts[MAX_COLORS + 1] = {};
+	for (int i = island.begin; i < island.end; i++)
+	{
+		SolverPoint& point = m_points[i];
+		bool kinematicA = m_store->m_kinematic[point.bodyA] != 0;
+		bool kinematicB = m_store->m_kinematic[point.bodyB] != 0;
+
+		uint64_t used = (kinematicA ? 0 : m_bodyColors[point.bodyA]) | (kinematicB ? 0 : m_bodyColors[point.bodyB]);
+
+		int color = 0;
+		while (color < MAX_COLORS && (used & ((uint64_t)1 << color)) != 0)
+		{
+			color++;
+		}
+
+		point.color = color;
+		counts[color]++;
+		if (color < MAX_COLORS)
+		{
+			m_bodyColors[point.bodyA] |= (uint64_t)1 << color;
+			m_bodyColors[point.bodyB] |= (uint64_t)1 << color;
+		}
+	}
+
+	// record where each colour starts and sort the points into them
+	island.firstColor = (int)m_colorOffsets.size();
+	island.colorCount = 0;
+
+	int cursors[MAX_COLORS + 1];
+	int begin = island.begin;
+	int batch = m_batchOffsets.empty() ? 0 : m_batchOffsets.back();
+	for (int color = 0; color <= MAX_COLORS; color++)
+	{
+		if (counts[color] > 0)
+		{
+			island.colorCount = color + 1;
+		}
+		cursors[color] = begin;
+		m_colorOffsets.push_back(begin);
+		m_batchOffsets.push_back(batch);
+		begin += counts[color];
+
+		if (color < MAX_COLORS)
+		{
+			batch += (counts[color] + BATCH_WIDTH - 1) / BATCH_WIDTH;
+		}
+	}
+	m_colorOffsets.push_back(begin);
+	m_batchOffsets.push_back(batch);
+
+	for (int i = island.begin; i < island.end; i++)
+	{
+		m_sortedPoints[cursors[m_points[i].color]++] = m_points[i];
+	}
+	std::copy(m_sortedPoints.begin() + island.begin, m_sortedPoints.begin() + island.end,
+		m_points.begin() + island.begin);
+}
+
+// starts each point off with the impulse it ended up with last step
+void ContactSolver::warmStart(const int begin, const int end)
+{
+	for (int i = begin; i < end; i++)
+	{
+		SolverPoint& point = m_points[i];
+
+		CachedImpulse search;
+		search.key = point.key;
+		search.featureId = point.featureId;
+		search.point = point.point;
+
+		auto cached = std::lower_bound(m_cache.begin(), m_cache.end(), search);
+		if (cached == m_cache.end() || cached->key != point.key ||
+			cached->featureId != point.featureId || cached->point != point.point)
+		{
+			continue;
+		}
+
+		point.normalImpulse = cached->normalImpulse;
+		point.tangentImpulse = cached->tangentImpulse;
+
+		glm::vec2 tangent(point.normal.y, -point.normal.x);
+		applyImpulse(point, point.normal * point.normalImpulse + tangent * point.tangentImpulse);
+	}
+}
+
+void ContactSolver::solveVelocities(const int begin, const int end)
+{
+	BodyStore& store = *m_store;
+
+	for (int i = begin; i < end; i++)
+	{
+		SolverPoint& point = m_points[i];
+		int a = point.bodyA;
+		int b = point.bodyB;
+		glm::vec2 tangent(point.normal.y, -point.normal.x);
+
+		// the relative velocity of the contact point
+		glm::vec2 velocityA(store.m_velocityX[a] - store.m_angularVelocity[a] * point.rA.y,
+			store.m_velocityY[a] + store.m_angularVelocity[a] * point.rA.x);
+		glm::vec2 velocityB(store.m_velocityX[b] - store.m_angularVelocity[b] * point.rB.y,
+			store.m_velocityY[b] + store.m_angularVelocity[b] * point.rB.x);
+		glm::vec2 relativeVelocity = velocityB - velocityA;
+
+		// friction, clamped by how hard the point is being pushed together
+		float lambda = -point.tangentMass * glm::dot(relativeVelocity, tangent);
+		float maxFriction = point.friction * point.normalImpulse;
+		float tangentImpulse = std::fmaxf(-maxFriction, std::fminf(point.tangentImpulse + lambda, maxFriction));
+		lambda = tangentImpulse - point.tangentImpulse;
+		point.tangentImpulse = tangentImpulse;
+		applyImpulse(point, tangent * lambda);
+
+		velocityA = glm::vec2(store.m_velocityX[a] - store.m_angularVelocity[a] * point.rA.y,
+			store.m_velocityY[a] + store.m_angularVelocity[a] * point.rA.x);
+		velocityB = glm::vec2(store.m_velocityX[b] - store.m_angularVelocity[b] * point.rB.y,
+			store.m_velocityY[b] + store.m_angularVelocity[b] * point.rB.x);
+		relativeVelocity = velocityB - velocityA;
+
+		// the total normal impulse can only ever push the bodies apart
+		lambda = -point.normalMass * (glm::dot(relativeVelocity, point.normal) - point.bias);
+		float normalImpulse = std::fmaxf(point.normalImpulse + lambda, 0.0f);
+		lambda = normalImpulse - point.normalImpulse;
+		point.normalImpulse = normalImpulse;
+		applyImpulse(point, point.normal * lambda);
+	}
+}
+
+void ContactSolver::solvePositions(const int begin, const int end)
+{
+	BodyStore& store = *m_store;
+
+	for (int i = begin; i < end; i++)
+	{
+		SolverPoint& point = m_points[i];
+		int a = point.bodyA;
+		int b = point.bodyB;
+
+		float invMass = point.invMassA + point.invMassB;
+		if (invMass == 0)
+		{
+			continue;
+		}
+
+		// how far apart the bodies are now, after the pushes so far
+		glm::vec2 movedA = glm::vec2(store.m_positionX[a], store.m_positionY[a]) - point.startA;
+		glm::vec2 movedB = glm::vec2(store.m_positionX[b], store.m_positionY[b]) - point.startB;
+		float separation = point.separation + glm::dot(movedB - movedA, point.normal);
+
+		float correction = BAUMGARTE * std::fminf(separation + LINEAR_SLOP, 0.0f);
+		if (correction < 0)
+		{
+			glm::vec2 push = point.normal * (-correction / invMass);
+			// kinematic bodies are shared between islands so never touch them
+			if (!store.m_kinematic[a])
+			{
+				store.m_positionX[a] -= push.x * point.invMassA;
+				store.m_positionY[a] -= push.y * point.invMassA;
+			}
+			if (!store.m_kinematic[b])
+			{
+				store.m_positionX[b] += push.x * point.invMassB;
+				store.m_positionY[b] += push.y * point.invMassB;
+			}
+		}
+	}
+}
+
+void ContactSolver::packBatches(const IslandRange& island)
+{
+	BodyStore& store = *m_store;
+
+	// the overflow colour isn't batched
+	int colorCount = std::min(island.colorCount, MAX_COLORS);
+	for (int color = 0; color < colorCount; color++)
+	{
+		int offset = island.firstColor + color;
+		int begin = m_colorOffsets[offset];
+		int end = m_colorOffsets[offset + 1];
+
+		for (int i = begin; i < end; i += BATCH_WIDTH)
+		{
+			ContactBatch& batch = m_batches[m_batchOffsets[offset] + (i - begin) / BATCH_WIDTH];
+			batch = ContactBatch();
+
+			for (int lane = 0; lane < BATCH_WIDTH; lane++)
+			{
+				if (i + lane >= end)
+				{
+					batch.bodyA[lane] = -1;
+					batch.bodyB[lane] = -1;
+					batch.point[lane] = -1;
+					continue;
+				}
+
+				const SolverPoint& point = m_points[i + lane];
+				int a = point.bodyA;
+				int b = point.bodyB;
+
+				batch.bodyA[lane] = a;
+				batch.bodyB[lane] = b;
+				batch.point[lane] = i + lane;
+
+				batch.normalX[lane] = point.normal.x;
+				batch.normalY[lane] = point.normal.y;
+				batch.rAx[lane] = point.rA.x;
+				batch.rAy[lane] = point.rA.y;
+				batch.rBx[lane] = point.rB.x;
+				batch.rBy[lane] = point.rB.y;
+
+				batch.invMassA[lane] = point.invMassA;
+				batch.invMomentA[lane] = store.m_kinematic[a] ? 0.0f : store.m_invMoment[a];
+				batch.invMassB[lane] = point.invMassB;
+				batch.invMomentB[lane] = store.m_kinematic[b] ? 0.0f : store.m_invMoment[b];
+
+				batch.normalMass[lane] = point.normalMass;
+				batch.tangentMass[lane] = point.tangentMass;
+				batch.bias[lane] = point.bias;
+				batch.friction[lane] = point.friction;
+
+				batch.normalImpulse[lane] = point.normalImpulse;
+				batch.tangentImpulse[lane] = point.tangentImpulse;
+			}
+		}
+	}
+}
+
+void ContactSolver::unpackBatches(const IslandRange& island)
+{
+	int colorCount = std::min(island.colorCount, MAX_COLORS);
+	int begin = m_batchOffsets[island.firstColor];
+	int end = m_batchOffsets[island.firstColor + colorCount];
+
+	for (int i = begin; i < end; i++)
+	{
+		ContactBatch& batch = m_batches[i];
+		for (int lane = 0; lane < BATCH_WIDTH; lane++)
+		{
+			if (batch.point[lane] >= 0)
+			{
+				m_points[batch.point[lane]].normalImpulse = batch.normalImpulse[lane];
+				m_points[batch.point[lane]].tangentImpulse = batch.tangentImpulse[lane];
+			}
+		}
+	}
+}
+
+void ContactSolver::solveBatches(const int begin, const int end)
+{
+	BodyStore& store = *m_store;
+
+	for (int i = begin; i < end; i++)
+	{
+		ContactBatch& batch = m_batches[i];
+
+		// no two lanes share a body that can move, so the lanes can be
+		// gathered, solved side by side and scattered back
+		BatchVelocities velocities;
+		for (int lane = 0; lane < BATCH_WIDTH; lane++)
+		{
+			int a = batch.bodyA[lane];
+			int b = batch.bodyB[lane];
+			velocities.vAx[lane] = a < 0 ? 0.0f : store.m_velocityX[a];
+			velocities.vAy[lane] = a < 0 ? 0.0f : store.m_velocityY[a];
+			velocities.wA[lane] = a < 0 ? 0.0f : store.m_angularVelocity[a];
+			velocities.vBx[lane] = b < 0 ? 0.0f : store.m_velocityX[b];
+			velocities.vBy[lane] = b < 0 ? 0.0f : store.m_velocityY[b];
+			velocities.wB[lane] = b < 0 ? 0.0f : store.m_angularVelocity[b];
+		}
+
+#if defined(PHYSICS_SIMD_AVX2)
+		solveBatch8(batch, velocities);
+#elif defined(PHYSICS_SIMD_SSE2)
+		solveBatch4(batch, velocities);
+#else
+		solveBatchScalar(batch, velocities);
+#endif
+
+		// kinematic bodies can be in more than one lane, and in batches on
+		// other threads, so only the ones that moved are written back
+		for (int lane = 0; lane < BATCH_WIDTH; lane++)
+		{
+			int a = batch.bodyA[lane];
+			int b = batch.bodyB[lane];
+			if (a >= 0 && !store.m_kinematic[a])
+			{
+				store.m_velocityX[a] = velocities.vAx[lane];
+				store.m_velocityY[a] = velocities.vAy[lane];
+				store.m_angularVelocity[a] = velocities.wA[lane];
+			}
+			if (b >= 0 && !store.m_kinematic[b])
+			{
+				store.m_velocityX[b] = velocities.vBx[lane];
+				store.m_velocityY[b] = velocities.vBy[lane];
+				store.m_angularVelocity[b] = velocities.wB[lane];
+			}
+		}
+	}
+}
+
+// the same friction then normal impulse as solveVelocities, a lane at a time
+void ContactSolver::solveBatchScalar(ContactBatch& batch, BatchVelocities& velocities)
+{
+	BatchVelocities& v = velocities;
+
+	for (int lane = 0; lane < BATCH_WIDTH; lane++)
+	{
+		float nx = batch.normalX[lane];
+		float ny = batch.normalY[lane];
+
+		// friction along the tangent (ny, -nx)
+		float dvx = (v.vBx[lane] - v.wB[lane] * batch.rBy[lane]) - (v.vAx[lane] - v.wA[lane] * batch.rAy[lane]);
+		float dvy = (v.vBy[lane] + v.wB[lane] * batch.rBx[lane]) - (v.vAy[lane] + v.wA[lane] * batch.rAx[lane]);
+		float lambda = -(batch.tangentMass[lane] * (dvx * ny - dvy * nx));
+		float maxFriction = batch.friction[lane] * batch.normalImpulse[lane];
+		float tangentImpulse = std::fmaxf(-maxFriction, std::fminf(batch.tangentImpulse[lane] + lambda, maxFriction));
+		lambda = tangentImpulse - batch.tangentImpulse[lane];
+		batch.tangentImpulse[lane] = tangentImpulse;
+
+		float px = ny * lambda;
+		float py = -nx * lambda;
+		v.vAx[lane] -= px * batch.invMassA[lane];
+		v.vAy[lane] -= py * batch.invMassA[lane];
+		v.wA[lane] -= (batch.rAx[lane] * py - batch.rAy[lane] * px) * batch.invMomentA[lane];
+		v.vBx[lane] += px * batch.invMassB[lane];
+		v.vBy[lane] += py * batch.invMassB[lane];
+		v.wB[lane] += (batch.rBx[lane] * py - batch.rBy[lane] * px) * batch.invMomentB[lane];
+
+		// the normal impulse only ever pushes apart
+		dvx = (v.vBx[lane] - v.wB[lane] * batch.rBy[lane]) - (v.vAx[lane] - v.wA[lane] * batch.rAy[lane]);
+		dvy = (v.vBy[lane] + v.wB[lane] * batch.rBx[lane]) - (v.vAy[lane] + v.wA[lane] * batch.rAx[lane]);
+		lambda = -(batch.normalMass[lane] * ((dvx * nx + dvy * ny) - batch.bias[lane]));
+		float normalImpulse = std::fmaxf(batch.normalImpulse[lane] + lambda, 0.0f);
+		lambda = normalImpulse - batch.normalImpulse[lane];
+		batch.normalImpulse[lane] = normalImpulse;
+
+		px = nx * lambda;
+		py = ny * lambda;
+		v.vAx[lane] -= px * batch.invMassA[lane];
+		v.vAy[lane] -= py * batch.invMassA[lane];
+		v.wA[lane] -= (batch.rAx[lane] * py - batch.rAy[lane] * px) * batch.invMomentA[lane];
+		v.vBx[lane] += px * batch.invMassB[lane];
+		v.vBy[lane] += py * batch.invMassB[lane];
+		v.wB[lane] += (batch.rBx[lane] * py - batch.rBy[lane] * px) * batch.invMomentB[lane];
+	}
+}
+
+#if defined(PHYSICS_SIMD_AVX2)
+// the same as solveBatchScalar for all 8 lanes at once
+void ContactSolver::solveBatch8(ContactBatch& batch, BatchVelocities& velocities)
+{
+	const __m256 zero = _mm256_setzero_ps();
+
+	__m256 nx = _mm256_loadu_ps(batch.normalX);
+	__m256 ny = _mm256_loadu_ps(batch.normalY);
+	__m256 rAx = _mm256_loadu_ps(batch.rAx);
+	__m256 rAy = _mm256_loadu_ps(batch.rAy);
+	__m256 rBx = _mm256_loadu_ps(batch.rBx);
+	__m256 rBy = _mm256_loadu_ps(batch.rBy);
+	__m256 invMassA = _mm256_loadu_ps(batch.invMassA);
+	__m256 invMomentA = _mm256_loadu_ps(batch.invMomentA);
+	__m256 invMassB = _mm256_loadu_ps(batch.invMassB);
+	__m256 invMomentB = _mm256_loadu_ps(batch.invMomentB);
+
+	__m256 vAx = _mm256_loadu_ps(velocities.vAx);
+	__m256 vAy = _mm256_loadu_ps(velocities.vAy);
+	__m256 wA = _mm256_loadu_ps(velocities.wA);
+	__m256 vBx = _mm256_loadu_ps(velocities.vBx);
+	__m256 vBy = _mm256_loadu_ps(velocities.vBy);
+	__m256 wB = _mm256_loadu_ps(velocities.wB);
+
+	// friction along the tangent (ny, -nx)
+	__m256 dvx = _mm256_sub_ps(_mm256_sub_ps(vBx, _mm256_mul_ps(wB, rBy)), _mm256_sub_ps(vAx, _mm256_mul_ps(wA, rAy)));
+	__m256 dvy = _mm256_sub_ps(_mm256_add_ps(vBy, _mm256_mul_ps(wB, rBx)), _mm256_add_ps(vAy, _mm256_mul_ps(wA, rAx)));
+	__m256 vt = _mm256_sub_ps(_mm256_mul_ps(dvx, ny), _mm256_mul_ps(dvy, nx));
+	__m256 lambda = _mm256_sub_ps(zero, _mm256_mul_ps(_mm256_loadu_ps(batch.tangentMass), vt));
+	__m256 oldImpulse = _mm256_loadu_ps(batch.tangentImpulse);
+	__m256 maxFriction = _mm256_mul_ps(_mm256_loadu_ps(batch.friction), _mm256_loadu_ps(batch.normalImpulse));
+	__m256 impulse = _mm256_max_ps(_mm256_sub_ps(zero, maxFriction), _mm256_min_ps(_mm256_add_ps(oldImpulse, lambda), maxFriction));
+	lambda = _mm256_sub_ps(impulse, oldImpulse);
+	_mm256_storeu_ps(batch.tangentImpulse, impulse);
+
+	__m256 px = _mm256_mul_ps(ny, lambda);
+	__m256 py = _mm256_mul_ps(_mm256_sub_ps(zero, nx), lambda);
+	vAx = _mm256_sub_ps(vAx, _mm256_mul_ps(px, invMassA));
+	vAy = _mm256_sub_ps(vAy, _mm256_mul_ps(py, invMassA));
+	wA = _mm256_sub_ps(wA, _mm256_mul_ps(_mm256_sub_ps(_mm256_mul_ps(rAx, py), _mm256_mul_ps(rAy, px)), invMomentA));
+	vBx = _mm256_add_ps(vBx, _mm256_mul_ps(px, invMassB));
+	vBy = _mm256_add_ps(vBy, _mm256_mul_ps(py, invMassB));
+	wB = _mm256_add_ps(wB, _mm256_mul_ps(_mm256_sub_ps(_mm256_mul_ps(rBx, py), _mm256_mul_ps(rBy, px)), invMomentB));
+
+	// the normal impulse only ever pushes apart
+	dvx = _mm256_sub_ps(_mm256_sub_ps(vBx, _mm256_mul_ps(wB, rBy)), _mm256_sub_ps(vAx, _mm256_mul_ps(wA, rAy)));
+	dvy = _mm256_sub_ps(_mm256_add_ps(vBy, _mm256_mul_ps(wB, rBx)), _mm256_add_ps(vAy, _mm256_mul_ps(wA, rAx)));
+	__m256 vn = _mm256_add_ps(_mm256_mul_ps(dvx, nx), _mm256_mul_ps(dvy, ny));
+	lambda = _mm256_sub_ps(zero, _mm256_mul_ps(_mm256_loadu_ps(batch.normalMass), _mm256_sub_ps(vn, _mm256_loadu_ps(batch.bias))));
+	oldImpulse = _mm256_loadu_ps(batch.normalImpulse);
+	impulse = _mm256_max_ps(_mm256_add_ps(oldImpulse, lambda), zero);
+	lambda = _mm256_sub_ps(impulse, oldImpulse);
+	_mm256_storeu_ps(batch.normalImpulse, impulse);
+
+	px = _mm256_mul_ps(nx, lambda);
+	py = _mm256_mul_ps(ny, lambda);
+	vAx = _mm256_sub_ps(vAx, _mm256_mul_ps(px, invMassA));
+	vAy = _mm256_sub_ps(vAy, _mm256_mul_ps(py, invMassA));
+	wA = _mm256_sub_ps(wA, _mm256_mul_ps(_mm256_sub_ps(_mm256_mul_ps(rAx, py), _mm256_mul_ps(rAy, px)), invMomentA));
+	vBx = _mm256_add_ps(vBx, _mm256_mul_ps(px, invMassB));
+	vBy = _mm256_add_ps(vBy, _mm256_mul_ps(py, invMassB));
+	wB = _mm256_add_ps(wB, _mm256_mul_ps(_mm256_sub_ps(_mm256_mul_ps(rBx, py), _mm256_mul_ps(rBy, px)), invMomentB));
+
+	_mm256_storeu_ps(velocities.vAx, vAx);
+	_mm256_storeu_ps(velocities.vAy, vAy);
+	_mm256_storeu_ps(velocities.wA, wA);
+	_mm256_storeu_ps(velocities.vBx, vBx);
+	_mm256_storeu_ps(velocities.vBy, vBy);
+	_mm256_storeu_ps(velocities.wB, wB);
+}
+#elif defined(PHYSICS_SIMD_SSE2)
+// the same as solveBatchScalar for all 4 lanes at once
+void ContactSolver::solveBatch4(ContactBatch& batch, BatchVelocities& velocities)
+{
+	const __m128 zero = _mm_setzero_ps();
+
+	__m128 nx = _mm_loadu_ps(batch.normalX);
+	__m128 ny = _mm_loadu_ps(batch.normalY);
+	__m128 rAx = _mm_loadu_ps(batch.rAx);
+	__m128 rAy = _mm_loadu_ps(batch.rAy);
+	__m128 rBx = _mm_loadu_ps(batch.rBx);
+	__m128 rBy = _mm_loadu_ps(batch.rBy);
+	__m128 invMassA = _mm_loadu_ps(batch.invMassA);
+	__m128 invMomentA = _mm_loadu_ps(batch.invMomentA);
+	__m128 invMassB = _mm_loadu_ps(batch.invMassB);
+	__m128 invMomentB = _mm_loadu_ps(batch.invMomentB);
+
+	__m128 vAx = _mm_loadu_ps(velocities.vAx);
+	__m128 vAy = _mm_loadu_ps(velocities.vAy);
+	__m128 wA = _mm_loadu_ps(velocities.wA);
+	__m128 vBx = _mm_loadu_ps(velocities.vBx);
+	__m128 vBy = _mm_loadu_ps(velocities.vBy);
+	__m128 wB = _mm_loadu_ps(velocities.wB);
+
+	// friction along the tangent (ny, -nx)
+	__m128 dvx = _mm_sub_ps(_mm_sub_ps(vBx, _mm_mul_ps(wB, rBy)), _mm_sub_ps(vAx, _mm_mul_ps(wA, rAy)));
+	__m128 dvy = _mm_sub_ps(_mm_add_ps(vBy, _mm_mul_ps(wB, rBx)), _mm_add_ps(vAy, _mm_mul_ps(wA, rAx)));
+	__m128 vt = _mm_sub_ps(_mm_mul_ps(dvx, ny), _mm_mul_ps(dvy, nx));
+	__m128 lambda = _mm_sub_ps(zero, _mm_mul_ps(_mm_loadu_ps(batch.tangentMass), vt));
+	__m128 oldImpulse = _mm_loadu_ps(batch.tangentImpulse);
+	__m128 maxFriction = _mm_mul_ps(_mm_loadu_ps(batch.friction), _mm_loadu_ps(batch.normalImpulse));
+	__m128 impulse = _mm_max_ps(_mm_sub_ps(zero, maxFriction), _mm_min_ps(_mm_add_ps(oldImpulse, lambda), maxFriction));
+	lambda = _mm_sub_ps(impulse, oldImpulse);
+	_mm_storeu_ps(batch.tangentImpulse, impulse);
+
+	__m128 px = _mm_mul_ps(ny, lambda);
+	__m128 py = _mm_mul_ps(_mm_sub_ps(zero, nx), lambda);
+	vAx = _mm_sub_ps(vAx, _mm_mul_ps(px, invMassA));
+	vAy = _mm_sub_ps(vAy, _mm_mul_ps(py, invMassA));
+	wA = _mm_sub_ps(wA, _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(rAx, py), _mm_mul_ps(rAy, px)), invMomentA));
+	vBx = _mm_add_ps(vBx, _mm_mul_ps(px, invMassB));
+	vBy = _mm_add_ps(vBy, _mm_mul_ps(py, invMassB));
+	wB = _mm_add_ps(wB, _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(rBx, py), _mm_mul_ps(rBy, px)), invMomentB));
+
+	// the normal impulse only ever pushes apart
+	dvx = _mm_sub_ps(_mm_sub_ps(vBx, _mm_mul_ps(wB, rBy)), _mm_sub_ps(vAx, _mm_mul_ps(wA, rAy)));
+	dvy = _mm_sub_ps(_mm_add_ps(vBy, _mm_mul_ps(wB, rBx)), _mm_add_ps(vAy, _mm_mul_ps(wA, rAx)));
+	__m128 vn = _mm_add_ps(_mm_mul_ps(dvx, nx), _mm_mul_ps(dvy, ny));
+	lambda = _mm_sub_ps(zero, _mm_mul_ps(_mm_loadu_ps(batch.normalMass), _mm_sub_ps(vn, _mm_loadu_ps(batch.bias))));
+	oldImpulse = _mm_loadu_ps(batch.normalImpulse);
+	impulse = _mm_max_ps(_mm_add_ps(oldImpulse, lambda), zero);
+	lambda = _mm_sub_ps(impulse, oldImpulse);
+	_mm_storeu_ps(batch.normalImpulse, impulse);
+
+	px = _mm_mul_ps(nx, lambda);
+	py = _mm_mul_ps(ny, lambda);
+	vAx = _mm_sub_ps(vAx, _mm_mul_ps(px, invMassA));
+	vAy = _mm_sub_ps(vAy, _mm_mul_ps(py, invMassA));
+	wA = _mm_sub_ps(wA, _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(rAx, py), _mm_mul_ps(rAy, px)), invMomentA));
+	vBx = _mm_add_ps(vBx, _mm_mul_ps(px, invMassB));
+	vBy = _mm_add_ps(vBy, _mm_mul_ps(py, invMassB));
+	wB = _mm_add_ps(wB, _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(rBx, py), _mm_mul_ps(rBy, px)), invMomentB));
+
+	_mm_storeu_ps(velocities.vAx, vAx);
+	_mm_storeu_ps(velocities.vAy, vAy);
+	_mm_storeu_ps(velocities.wA, wA);
+	_mm_storeu_ps(velocities.vBx, vBx);
+	_mm_storeu_ps(velocities.vBy, vBy);
+	_mm_storeu_ps(velocities.wB, wB);
+}
+#endif
+
+void ContactSolver::applyImpulse(const SolverPoint& point, const glm::vec2 impulse)
+{
+	BodyStore& store = *m_store;
+
+	int a = point.bodyA;
+	int b = point.bodyB;
+
+	if (!store.m_kinematic[a])
+	{
+		store.m_velocityX[a] -= impulse.x * store.m_invMass[a];
+		store.m_velocityY[a] -= impulse.y * store.m_invMass[a];
+		store.m_angularVelocity[a] -= (point.rA.x * impulse.y - point.rA.y * impulse.x) * store.m_invMoment[a];
+	}
+	if (!store.m_kinematic[b])
+	{
+		store.m_velocityX[b] += impulse.x * store.m_invMass[b];
+		store.m_velocityY[b] += impulse.y * store.m_invMass[b];
+		store.m_angularVelocity[b] += (point.rB.x * impulse.y - point.rB.y * impulse.x) * store.m_invMoment[b];
+	}
+}
+
+// remember this step's impulses for the next one
+void ContactSolver::updateCache()
+{
+	m_cache.clear();
+	m_cache.reserve(m_points.capacity());
+
+	for (auto& point : m_points)
+	{
+		CachedImpulse cached;
+		cached.key = point.key;
+		cached.featureId = point.featureId;
+		cached.point = point.point;
+		cached.normalImpulse = point.normalImpulse;
+		cached.tangentImpulse = point.tangentImpulse;
+		m_cache.push_back(cached);
+	}
+
+	std::sort(m_cache.begin(), m_cache.end());
+}
+
+void ContactSolver::remapBodies(const BodyStore& store)
+{
+	size_t kept = 0;
+	for (auto cached : m_cache)
+	{
+		int a = store.getNewRow((int)(cached.key >> 32));
+		int b = store.getNewRow((int)(uint32_t)cached.key);
+		if (a < 0 || b < 0)
+		{
+			continue;
+		}
+		cached.key = ((uint64_t)a << 32) | (uint32_t)b;
+		m_cache[kept++] = cached;
+	}
+	m_cache.resize(kept);
+	std::sort(m_cache.begin(), m_cache.end());
+}
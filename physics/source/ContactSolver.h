@@ -0,0 +1,266 @@
+#pragma once
+#include <glm/vec2.hpp>
+#include <vector>
+#include <cstdint>
+#include "Contact.h"
+#include "SimdMath.h"
+
+class BodyStore;
+class ThreadPool;
+class UnionFind;
+
+// sequential impulse contact solver
+// each contact point keeps an accumulated normal and friction impulse over
+// all the iterations, and it's the accumulated impulse that gets clamped.
+// the impulses from the last step are remembered in a cache keyed by body
+// pair and feature id and fed back in at the start of the next step, so
+// stacks start out close to their solution and can come to rest
+//
+// islands of touching bodies don't share anything they write to, so each
+// island is solved as its own task on the thread pool, biggest first.
+// bigger islands are graph coloured so the points of one colour share no
+// bodies. a colour is packed into batches that solve several points at
+// once with simd, and islands too big for one thread have each colour
+// spread over the pool. none of this depends on the thread count, so
+// neither do the results
+class ContactSolver
+{
+public:
+	ContactSolver() {};
+	~ContactSolver() {};
+
+	void setIterations(const int iterations) { m_iterations = iterations; }
+	int getIterations() const { return m_iterations; }
+
+	void setPositionIterations(const int iterations) { m_positionIterations = iterations; }
+	int getPositionIterations() const { return m_positionIterations; }
+
+	void setWarmStarting(const bool warmStarting) { m_warmStarting = warmStarting; }
+	bool getWarmStarting() const { return m_warmStarting; }
+
+	// solves the velocities of the bodies in the store for these contacts,
+	// then pushes them out of each other. islands groups the bodies that
+	// touch, and threadPool can be nullptr to solve everything inline
+	void solve(BodyStore& store, const std::vector<Contact>& contacts, UnionFind& islands, ThreadPool* threadPool);
+
+	// the cache is keyed by store row. removing bodies moves others into
+	// the gaps, so this forgets the removed bodies' impulses and moves the
+	// rest over to the rows the store has them in now
+	void remapBodies(const BodyStore& store);
+
+	// how many simd batches the coloured islands were packed into
+	size_t getBatchCount() const { return m_batches.size(); }
+
+	// the fraction of the penetration fixed each position iteration, and
+	// how much is allowed so resting contacts don't jitter
+	static constexpr float BAUMGARTE = 0.2f;
+	static constexpr float LINEAR_SLOP = 0.01f;
+
+	// contacts closing slower than this don't bounce
+	static constexpr float RESTITUTION_THRESHOLD = 5.0f;
+
+	// islands with at least this many points are coloured and solved a
+	// batch at a time
+	static constexpr int BATCH_ISLAND_POINTS = 32;
+
+	// islands with more points than this are split up over the pool
+	static constexpr int GIANT_ISLAND_POINTS = 256;
+
+	// how many points are solved at once, one per simd lane
+#if defined(PHYSICS_SIMD_AVX2)
+	static constexpr int BATCH_WIDTH = 8;
+#else
+	static constexpr int BATCH_WIDTH = 4;
+#endif
+
+	// how many points of one colour each task gets
+	static constexpr int POINTS_PER_TASK = 64;
+
+	// the colours past this one go into a last colour that's solved on
+	// one thread
+	static constexpr int MAX_COLORS = 63;
+
+protected:
+
+	struct SolverPoint
+	{
+		int bodyA;
+		int bodyB;
+
+		glm::vec2 normal;
+		glm::vec2 rA;
+		glm::vec2 rB;
+
+		float normalMass;
+		float tangentMass;
+		float bias;
+		float friction;
+
+		// for fixing the penetration, the separation is negative when the
+		// bodies overlap and the start positions track how far they've
+		// been pushed since
+		float separation;
+		float invMassA;
+		float invMassB;
+		glm::vec2 startA;
+		glm::vec2 startB;
+
+		float normalImpulse;
+		float tangentImpulse;
+
+		// what the point is cached under
+		uint64_t key;
+		uint32_t featureId;
+		int point;
+
+		// the island, and within a giant island the colour
+		int island;
+		int color;
+	};
+
+	// a run of m_points belonging to one island, and for giant islands the
+	// run of m_colorOffsets giving where each colour starts
+	struct IslandRange
+	{
+		int begin;
+		int end;
+		int firstColor;
+		int colorCount;
+
+		bool operator<(const IslandRange& other) const
+		{
+			// biggest first, then in the order they were found
+			if (end - begin != other.end - other.begin) return end - begin > other.end - other.begin;
+			return begin < other.begin;
+		}
+	};
+
+	// BATCH_WIDTH points of one colour stored lane by lane. the padding
+	// lanes at the end of a colour have no bodies and no mass so they
+	// never push anything
+	struct ContactBatch
+	{
+		int bodyA[BATCH_WIDTH];
+		int bodyB[BATCH_WIDTH];
+		int point[BATCH_WIDTH];
+
+		float normalX[BATCH_WIDTH];
+		float normalY[BATCH_WIDTH];
+		float rAx[BATCH_WIDTH];
+		float rAy[BATCH_WIDTH];
+		float rBx[BATCH_WIDTH];
+		float rBy[BATCH_WIDTH];
+
+		float invMassA[BATCH_WIDTH];
+		float invMomentA[BATCH_WIDTH];
+		float invMassB[BATCH_WIDTH];
+		float invMomentB[BATCH_WIDTH];
+
+		float normalMass[BATCH_WIDTH];
+		float tangentMass[BATCH_WIDTH];
+		float bias[BATCH_WIDTH];
+		float friction[BATCH_WIDTH];
+
+		float normalImpulse[BATCH_WIDTH];
+		float tangentImpulse[BATCH_WIDTH];
+	};
+
+	// the velocities of the bodies of one batch, gathered from the store
+	struct BatchVelocities
+	{
+		float vAx[BATCH_WIDTH];
+		float vAy[BATCH_WIDTH];
+		float wA[BATCH_WIDTH];
+		float vBx[BATCH_WIDTH];
+		float vBy[BATCH_WIDTH];
+		float wB[BATCH_WIDTH];
+	};
+
+	struct CachedImpulse
+	{
+		uint64_t key;
+		uint32_t featureId;
+		int point;
+
+		float normalImpulse;
+		float tangentImpulse;
+
+		bool operator<(const CachedImpulse& other) const
+		{
+			if (key != other.key) return key < other.key;
+			if (featureId != other.featureId) return featureId < other.featureId;
+			return point < other.point;
+		}
+	};
+
+	void prepare(BodyStore& store, const std::vector<Contact>& contacts, UnionFind& islands);
+
+	// sorts m_points by island and fills m_islandRanges
+	void groupIslands(const int bodyCount);
+
+	// sorts the points of an island by colour
+	void colorIsland(IslandRange& island);
+
+	// solves one island start to finish on this thread
+	void solveIsland(const IslandRange& island);
+	static void solveIslandTask(void* solver, int index);
+
+	// solves a giant island a colour at a time across the pool
+	void solveColoredIsland(const IslandRange& island);
+	static void solveColorTask(void* solver, int index);
+
+	// copies the points of a coloured island into m_batches and the
+	// impulses back out again
+	void packBatches(const IslandRange& island);
+	void unpackBatches(const IslandRange& island);
+
+	// solves the velocities of m_batches[begin, end)
+	void solveBatches(const int begin, const int end);
+	void solveBatchScalar(ContactBatch& batch, BatchVelocities& velocities);
+#if defined(PHYSICS_SIMD_AVX2)
+	void solveBatch8(ContactBatch& batch, BatchVelocities& velocities);
+#elif defined(PHYSICS_SIMD_SSE2)
+	void solveBatch4(ContactBatch& batch, BatchVelocities& velocities);
+#endif
+
+	// these work on m_points[begin, end)
+	void warmStart(const int begin, const int end);
+	void solveVelocities(const int begin, const int end);
+	void solvePositions(const int begin, const int end);
+	void updateCache();
+
+	// applies an impulse to the two bodies of a point, the impulse pushes b
+	// and the opposite pushes a
+	void applyImpulse(const SolverPoint& point, const glm::vec2 impulse);
+
+	std::vector<SolverPoint> m_points;
+
+	// scratch space for sorting the points, reused every step
+	std::vector<SolverPoint> m_sortedPoints;
+	std::vector<int> m_islandIds;
+	std::vector<uint64_t> m_bodyColors;
+
+	std::vector<IslandRange> m_islandRanges;
+	std::vector<int> m_colorOffsets;
+	int m_giantIslandCount = 0;
+
+	// the batches of each colour, the overflow colour doesn't get any
+	std::vector<ContactBatch> m_batches;
+	std::vector<int> m_batchOffsets;
+
+	// what the tasks are working on
+	BodyStore* m_store = nullptr;
+	ThreadPool* m_threadPool = nullptr;
+	int m_colorBegin = 0;
+	int m_colorEnd = 0;
+	int m_batchBegin = 0;
+	int m_batchEnd = 0;
+	bool m_solvingPositions = false;
+
+	// sorted so points can find their impulse from last step
+	std::vector<CachedImpulse> m_cache;
+
+	int m_iterations = 8;
+	int m_positionIterations = 3;
+	bool m_warmStarting = true;
+};
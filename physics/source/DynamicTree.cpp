@@ -0,0 +1,698 @@
+#include "DynamicTree.h"
+#include "Plane.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+// returns the perimeter of a box, used as the cost of a node
+static float perimeter(const glm::vec2 min, const glm::vec2 max)
+{
+	return 2.0f * ((max.x - min.x) + (max.y - min.y));
+}
+
+static bool overlaps(const glm::vec2 aMin, const glm::vec2 aMax, const glm::vec2 bMin, const glm::vec2 bMax)
+{
+	return !(aMax.x < bMin.x || aMin.x > bMax.x || aMax.y < bMin.y || aMin.y > bMax.y);
+}
+
+// whether a ray with a unit direction crosses a plane's line within maxDistance
+static bool planeHit(const Plane* plane, const glm::vec2 origin, const glm::vec2 direction, const float maxDistance)
+{
+	float offset = glm::dot(origin, plane->getNormal()) - plane->getDistance();
+	float speed = glm::dot(direction, plane->getNormal());
+	if (offset == 0.0f)
+	{
+		return true;
+	}
+	if (speed == 0.0f)
+	{
+		return false;
+	}
+
+	float t = -offset / speed;
+	return t >= 0.0f && t <= maxDistance;
+}
+
+DynamicTree::DynamicTree(const float margin) : m_margin(margin)
+{
+
+}
+
+void DynamicTree::addActor(PhysicsObject* actor)
+{
+	glm::vec2 min, max;
+	actor->getBounds(min, max);
+
+	int leaf = allocateNode();
+	Node& node = m_nodes[leaf];
+	node.actor = actor;
+	actor->setBroadphaseId(leaf);
+
+	if (!(max.x - min.x < FLT_MAX && max.y - min.y < FLT_MAX))
+	{
+		node.unbounded = true;
+		node.index = (int)m_unbounded.size();
+		m_unbounded.push_back(actor);
+		return;
+	}
+
+	node.tightMin = min;
+	node.tightMax = max;
+	node.min = min - glm::vec2(m_margin);
+	node.max = max + glm::vec2(m_margin);
+	node.index = (int)m_leaves.size();
+
+	insertLeaf(leaf);
+	m_leaves.push_back(leaf);
+
+	// treat it as moved so its pairs are found on the next step
+	m_nodes[leaf].moved = true;
+	m_moved.push_back(leaf);
+}
+
+void DynamicTree::removeActor(PhysicsObject* actor)
+{
+	int leaf = actor->getBroadphaseId();
+	if (leaf < 0 || leaf >= (int)m_nodes.size() || m_nodes[leaf].height < 0 || m_nodes[leaf].actor != actor)
+	{
+		return;
+	}
+	actor->setBroadphaseId(-1);
+
+	// swap the last one into the gap
+	Node& node = m_nodes[leaf];
+	if (node.unbounded)
+	{
+		PhysicsObject* last = m_unbounded.back();
+		m_unbounded[node.index] = last;
+		m_nodes[last->getBroadphaseId()].index = node.index;
+		m_unbounded.pop_back();
+		freeNode(leaf);
+		return;
+	}
+
+	int last = m_leaves.back();
+	m_leaves[node.index] = last;
+	m_nodes[last].index = node.index;
+	m_leaves.pop_back();
+
+	removeLeaf(leaf);
+	m_nodes[leaf].actor = nullptr;
+	m_removed.push_back(leaf);
+}
+
+// drops the pairs and moves of every leaf removed since the last step in
+// one pass, then frees their nodes
+void DynamicTree::removePending()
+{
+	if (m_removed.empty())
+	{
+		return;
+	}
+
+	m_pairKeys.erase(std::remove_if(m_pairKeys.begin(), m_pairKeys.end(),
+		[this](const uint64_t key) { return m_nodes[(int)(key >> 32)].actor == nullptr || m_nodes[(int)(key & 0xffffffff)].actor == nullptr; }),
+		m_pairKeys.end());
+	m_moved.erase(std::remove_if(m_moved.begin(), m_moved.end(),
+		[this](const int leaf) { return m_nodes[leaf].actor == nullptr; }), m_moved.end());
+
+	for (int leaf : m_removed)
+	{
+		freeNode(leaf);
+	}
+	m_removed.clear();
+}
+
+// the leaves already track every actor, so the list isn't needed
+void DynamicTree::findPairs(const std::vector<PhysicsObject*>&, std::vector<CollisionPair>& pairs)
+{
+	removePending();
+
+	// only reinsert the leaves whose actor has left its fat bounds. the
+	// bounds of sleeping actors aren't worked out, so they stay where they
+	// are until they wake
+	for (int leaf : m_leaves)
+	{
+		Node& node = m_nodes[leaf];
+		if (node.actor->isSleeping())
+		{
+			continue;
+		}
+		node.actor->getBounds(node.tightMin, node.tightMax);
+
+		if (node.tightMin.x >= node.min.x && node.tightMin.y >= node.min.y &&
+			node.tightMax.x <= node.max.x && node.tightMax.y <= node.max.y)
+		{
+			continue;
+		}
+
+		removeLeaf(leaf);
+		m_nodes[leaf].min = m_nodes[leaf].tightMin - glm::vec2(m_margin);
+		m_nodes[leaf].max = m_nodes[leaf].tightMax + glm::vec2(m_margin);
+		insertLeaf(leaf);
+
+		if (!m_nodes[leaf].moved)
+		{
+			m_nodes[leaf].moved = true;
+			m_moved.push_back(leaf);
+		}
+	}
+
+	m_movedCount = (int)m_moved.size();
+
+	if (!m_moved.empty())
+	{
+		// pairs between leaves that didn't move can't have changed
+		m_pairKeys.erase(std::remove_if(m_pairKeys.begin(), m_pairKeys.end(),
+			[this](const uint64_t key) { return m_nodes[(int)(key >> 32)].moved || m_nodes[(int)(key & 0xffffffff)].moved; }),
+			m_pairKeys.end());
+
+		m_newKeys.clear();
+		for (int leaf : m_moved)
+		{
+			queryLeaves(m_nodes[leaf].min, m_nodes[leaf].max, m_hits);
+			for (int other : m_hits)
+			{
+				// two moved leaves find each other, only keep one
+				if (other == leaf || (m_nodes[other].moved && other < leaf))
+				{
+					continue;
+				}
+				m_newKeys.push_back(pairKey(leaf, other));
+			}
+		}
+
+		for (int leaf : m_moved)
+		{
+			m_nodes[leaf].moved = false;
+		}
+		m_moved.clear();
+
+		std::sort(m_newKeys.begin(), m_newKeys.end());
+		m_scratchKeys.resize(m_pairKeys.size() + m_newKeys.size());
+		std::merge(m_pairKeys.begin(), m_pairKeys.end(), m_newKeys.begin(), m_newKeys.end(), m_scratchKeys.begin());
+		m_pairKeys.swap(m_scratchKeys);
+	}
+
+	// the fat pairs are a superset, so check the actual bounds
+	for (auto key : m_pairKeys)
+	{
+		const Node& a = m_nodes[(int)(key >> 32)];
+		const Node& b = m_nodes[(int)(key & 0xffffffff)];
+		if (canCollide(a.actor, b.actor) && overlaps(a.tightMin, a.tightMax, b.tightMin, b.tightMax))
+		{
+			pairs.push_back({ a.actor, b.actor });
+		}
+	}
+
+	for (int i = 0; i < (int)m_unbounded.size(); i++)
+	{
+		for (int j = i + 1; j < (int)m_unbounded.size(); j++)
+		{
+			if (canCollide(m_unbounded[i], m_unbounded[j]))
+			{
+				pairs.push_back({ m_unbounded[i], m_unbounded[j] });
+			}
+		}
+		// only the leaves touching a plane can collide with it
+		PhysicsObject* unbounded = m_unbounded[i];
+		if (unbounded->getShapeID() == PLANE)
+		{
+			queryPlane(static_cast<const Plane*>(unbounded), m_hits);
+		}
+		else
+		{
+			m_hits.assign(m_leaves.begin(), m_leaves.end());
+		}
+
+		for (int leaf : m_hits)
+		{
+			if (canCollide(unbounded, m_nodes[leaf].actor))
+			{
+				pairs.push_back({ unbounded, m_nodes[leaf].actor });
+			}
+		}
+	}
+}
+
+void DynamicTree::queryPoint(const glm::vec2 point, std::vector<PhysicsObject*>& results)
+{
+	queryAabb(point, point, results);
+}
+
+void DynamicTree::queryAabb(const glm::vec2 min, const glm::vec2 max, std::vector<PhysicsObject*>& results)
+{
+	queryLeaves(min, max, m_hits);
+	for (int leaf : m_hits)
+	{
+		const Node& node = m_nodes[leaf];
+		if (overlaps(min, max, node.tightMin, node.tightMax))
+		{
+			results.push_back(node.actor);
+		}
+	}
+	for (auto actor : m_unbounded)
+	{
+		if (actor->getShapeID() != PLANE || static_cast<const Plane*>(actor)->overlaps(min, max))
+		{
+			results.push_back(actor);
+		}
+	}
+}
+
+void DynamicTree::raycast(const glm::vec2 origin, const glm::vec2 direction, const float maxDistance,
+	std::vector<PhysicsObject*>& results)
+{
+	// a ray with no direction doesn't hit anything
+	float length = std::sqrt(direction.x * direction.x + direction.y * direction.y);
+	if (length <= 0.0f)
+	{
+		return;
+	}
+	glm::vec2 dir = direction / length;
+	glm::vec2 invDir(1.0f / dir.x, 1.0f / dir.y);
+
+	// slab test against a box, a zero component gives infinities that still compare correctly
+	auto hit = [&](const glm::vec2 min, const glm::vec2 max)
+	{
+		float tx1 = (min.x - origin.x) * invDir.x, tx2 = (max.x - origin.x) * invDir.x;
+		float ty1 = (min.y - origin.y) * invDir.y, ty2 = (max.y - origin.y) * invDir.y;
+		float tMin = std::max(std::min(tx1, tx2), std::min(ty1, ty2));
+		float tMax = std::min(std::max(tx1, tx2), std::max(ty1, ty2));
+		return tMax >= std::max(tMin, 0.0f) && tMin <= maxDistance;
+	};
+
+	if (m_root != NULL_NODE)
+	{
+		m_stack.clear();
+		m_stack.push_back(m_root);
+		while (!m_stack.empty())
+		{
+			int index = m_stack.back();
+			m_stack.pop_back();
+
+			const Node& node = m_nodes[index];
+			if (!hit(node.min, node.max))
+			{
+				continue;
+			}
+
+			if (node.isLeaf())
+			{
+				if (hit(node.tightMin, node.tightMax))
+				{
+					results.push_back(node.actor);
+				}
+			}
+			else
+			{
+				m_stack.push_back(node.child1);
+				m_stack.push_back(node.child2);
+			}
+		}
+	}
+	for (auto actor : m_unbounded)
+	{
+		if (actor->getShapeID() != PLANE || planeHit(static_cast<const Plane*>(actor), origin, dir, maxDistance))
+		{
+			results.push_back(actor);
+		}
+	}
+}
+
+// collects every leaf whose fat bounds overlap the box
+void DynamicTree::queryLeaves(const glm::vec2 min, const glm::vec2 max, std::vector<int>& leaves)
+{
+	leaves.clear();
+	if (m_root == NULL_NODE)
+	{
+		return;
+	}
+
+	m_stack.clear();
+	m_stack.push_back(m_root);
+	while (!m_stack.empty())
+	{
+		int index = m_stack.back();
+		m_stack.pop_back();
+
+		const Node& node = m_nodes[index];
+		if (!overlaps(min, max, node.min, node.max))
+		{
+			continue;
+		}
+
+		if (node.isLeaf())
+		{
+			leaves.push_back(index);
+		}
+		else
+		{
+			m_stack.push_back(node.child1);
+			m_stack.push_back(node.child2);
+		}
+	}
+}
+
+int DynamicTree::allocateNode()
+{
+	if (m_freeList == NULL_NODE)
+	{
+		m_nodes.push_back(Node());
+		m_nodes.back().parent = m_freeList;
+		m_freeList = (int)m_nodes.size() - 1;
+	}
+
+	int index = m_freeList;
+	Node& node = m_nodes[index];
+	m_freeList = node.parent;
+
+	node.parent = NULL_NODE;
+	node.child1 = NULL_NODE;
+	node.child2 = NULL_NODE;
+	node.height = 0;
+	node.actor = nullptr;
+	node.moved = false;
+	node.index = -1;
+	node.unbounded = false;
+	return index;
+}
+
+void DynamicTree::freeNode(const int node)
+{
+	m_nodes[node].parent = m_freeList;
+	m_nodes[node].height = -1;
+	m_freeList = node;
+}
+
+void DynamicTree::insertLeaf(const int leaf)
+{
+	if (m_root == NULL_NODE)
+	{
+		m_root = leaf;
+		m_nodes[leaf].parent = NULL_NODE;
+		return;
+	}
+
+	glm::vec2 leafMin = m_nodes[leaf].min;
+	glm::vec2 leafMax = m_nodes[leaf].max;
+
+	// walk down the tree to find the cheapest sibling for the new leaf
+	int index = m_root;
+	while (!m_nodes[index].isLeaf())
+	{
+		const Node& node = m_nodes[index];
+
+		float area = perimeter(node.min, node.max);
+		float combinedArea = perimeter(glm::min(node.min, leafMin), glm::max(node.max, leafMax));
+
+		// cost of making a new parent for this node and the leaf
+		float cost = 2.0f * combinedArea;
+
+		// the minimum cost of pushing the leaf further down the tree
+		float inheritanceCost = 2.0f * (combinedArea - area);
+
+		float childCost[2];
+		int children[2] = { node.child1, node.child2 };
+		for (int i = 0; i < 2; i++)
+		{
+			const Node& child = m_nodes[children[i]];
+			float childArea = perimeter(glm::min(child.min, leafMin), glm::max(child.max, leafMax));
+			if (!child.isLeaf())
+			{
+				childArea -= perimeter(child.min, child.max);
+			}
+			childCost[i] = childArea + inheritanceCost;
+		}
+
+		if (cost < childCost[0] && cost < childCost[1])
+		{
+			break;
+		}
+
+		index = childCost[0] < childCost[1] ? children[0] : children[1];
+	}
+
+	int sibling = index;
+
+	// create a new parent for the sibling and the leaf
+	int newParent = allocateNode();
+	int oldParent = m_nodes[sibling].parent;
+
+	Node& parent = m_nodes[newParent];
+	parent.parent = oldParent;
+	parent.min = glm::min(leafMin, m_nodes[sibling].min);
+	parent.max = glm::max(leafMax, m_nodes[sibling].max);
+	parent.height = m_nodes[sibling].height + 1;
+	parent.child1 = sibling;
+	parent.child2 = leaf;
+
+	if (oldParent != NULL_NODE)
+	{
+		if (m_nodes[oldParent].child1 == sibling)
+		{
+			m_nodes[oldParent].child1 = newParent;
+		}
+		else
+		{
+			m_nodes[oldParent].child2 = newParent;
+		}
+	}
+	else
+	{
+		m_root = newParent;
+	}
+	m_nodes[sibling].parent = newParent;
+	m_nodes[leaf].parent = newParent;
+
+	refit(m_nodes[leaf].parent);
+}
+
+void DynamicTree::removeLeaf(const int leaf)
+{
+	if (leaf == m_root)
+	{
+		m_root = NULL_NODE;
+		return;
+	}
+
+	int parent = m_nodes[leaf].parent;
+	int grandParent = m_nodes[parent].parent;
+	int sibling = m_nodes[parent].child1 == leaf ? m_nodes[parent].child2 : m_nodes[parent].child1;
+
+	// the sibling takes the parent's place
+	if (grandParent != NULL_NODE)
+	{
+		if (m_nodes[grandParent].child1 == parent)
+		{
+			m_nodes[grandParent].child1 = sibling;
+		}
+		else
+		{
+			m_nodes[grandParent].child2 = sibling;
+		}
+		m_nodes[sibling].parent = grandParent;
+		freeNode(parent);
+
+		refit(grandParent);
+	}
+	else
+	{
+		m_root = sibling;
+		m_nodes[sibling].parent = NULL_NODE;
+		freeNode(parent);
+	}
+}
+
+// walks up from a node, rebalancing and fixing the bounds and heights
+void DynamicTree::refit(int index)
+{
+	while (index != NULL_NODE)
+	{
+		index = balance(index);
+
+		Node& node = m_nodes[index];
+		const Node& child1 = m_nodes[node.child1];
+		const Node& child2 = m_nodes[node.child2];
+
+		node.height = 1 + std::max(child1.height, child2.height);
+		node.min = glm::min(child1.min, child2.min);
+		node.max = glm::max(child1.max, child2.max);
+
+		index = node.parent;
+	}
+}
+
+// rotates the taller child of a node up if its children's heights differ
+// by more than one, returns the node now at the top of this subtree
+int DynamicTree::balance(const int iA)
+{
+	Node& A = m_nodes[iA];
+	if (A.isLeaf() || A.height < 2)
+	{
+		return iA;
+	}
+
+	int iB = A.child1;
+	int iC = A.child2;
+	Node& B = m_nodes[iB];
+	Node& C = m_nodes[iC];
+
+	int difference = C.height - B.height;
+
+	// rotate C up
+	if (difference > 1)
+	{
+		int iF = C.child1;
+		int iG = C.child2;
+		Node& F = m_nodes[iF];
+		Node& G = m_nodes[iG];
+
+		// swap A and C
+		C.child1 = iA;
+		C.parent = A.parent;
+		A.parent = iC;
+
+		// A's old parent should point to C
+		if (C.parent != NULL_NODE)
+		{
+			if (m_nodes[C.parent].child1 == iA)
+			{
+				m_nodes[C.parent].child1 = iC;
+			}
+			else
+			{
+				m_nodes[C.parent].child2 = iC;
+			}
+		}
+		else
+		{
+			m_root = iC;
+		}
+
+		// keep the taller of C's children with C
+		if (F.height > G.height)
+		{
+			C.child2 = iF;
+			A.child2 = iG;
+			G.parent = iA;
+			A.min = glm::min(B.min, G.min);
+			A.max = glm::max(B.max, G.max);
+			C.min = glm::min(A.min, F.min);
+			C.max = glm::max(A.max, F.max);
+			A.height = 1 + std::max(B.height, G.height);
+			C.height = 1 + std::max(A.height, F.height);
+		}
+		else
+		{
+			C.child2 = iG;
+			A.child2 = iF;
+			F.parent = iA;
+			A.min = glm::min(B.min, F.min);
+			A.max = glm::max(B.max, F.max);
+			C.min = glm::min(A.min, G.min);
+			C.max = glm::max(A.max, G.max);
+			A.height = 1 + std::max(B.height, F.height);
+			C.height = 1 + std::max(A.height, G.height);
+		}
+		return iC;
+	}
+
+	// rotate B up
+	if (difference < -1)
+	{
+		int iD = B.child1;
+		int iE = B.child2;
+		Node& D = m_nodes[iD];
+		Node& E = m_nodes[iE];
+
+		// swap A and B
+		B.child1 = iA;
+		B.parent = A.parent;
+		A.parent = iB;
+
+		// A's old parent should point to B
+		if (B.parent != NULL_NODE)
+		{
+			if (m_nodes[B.parent].child1 == iA)
+			{
+				m_nodes[B.parent].child1 = iB;
+			}
+			else
+			{
+				m_nodes[B.parent].child2 = iB;
+			}
+		}
+		else
+		{
+			m_root = iB;
+		}
+
+		// keep the taller of B's children with B
+		if (D.height > E.height)
+		{
+			B.child2 = iD;
+			A.child1 = iE;
+			E.parent = iA;
+			A.min = glm::min(C.min, E.min);
+			A.max = glm::max(C.max, E.max);
+			B.min = glm::min(A.min, D.min);
+			B.max = glm::max(A.max, D.max);
+			A.height = 1 + std::max(C.height, E.height);
+			B.height = 1 + std::max(A.height, D.height);
+		}
+		else
+		{
+			B.child2 = iE;
+			A.child1 = iD;
+			D.parent = iA;
+			A.min = glm::min(C.min, D.min);
+			A.max = glm::max(C.max, D.max);
+			B.min = glm::min(A.min, E.min);
+			B.max = glm::max(A.max, E.max);
+			A.height = 1 + std::max(C.height, D.height);
+			B.height = 1 + std::max(A.height, E.height);
+		}
+		return iB;
+	}
+
+	return iA;
+}
+
+// collects every leaf whose bounds touch a plane. the fat bounds prune
+// the tree and the tight bounds decide the leaves
+void DynamicTree::queryPlane(const Plane* plane, std::vector<int>& leaves)
+{
+	leaves.clear();
+	if (m_root == NULL_NODE)
+	{
+		return;
+	}
+
+	m_stack.clear();
+	m_stack.push_back(m_root);
+	while (!m_stack.empty())
+	{
+		int index = m_stack.back();
+		m_stack.pop_back();
+
+		const Node& node = m_nodes[index];
+		if (!plane->overlaps(node.min, node.max))
+		{
+			continue;
+		}
+
+		if (node.isLeaf())
+		{
+			if (plane->overlaps(node.tightMin, node.tightMax))
+			{
+				leaves.push_back(index);
+			}
+		}
+		else
+		{
+			m_stack.push_back(node.child1);
+			m_stack.push_back(node.child2);
+		}
+	}
+}
@@ -0,0 +1,119 @@
+#pragma once
+#include "Broadphase.h"
+#include <glm/vec2.hpp>
+#include <cstdint>
+
+// dynamic bounding volume tree broadphase
+// every actor is a leaf holding "fat" bounds, its world bounds grown by a
+// margin. a leaf is only reinserted once the actor's bounds leave its fat
+// bounds, so the cost of a step scales with how many actors move rather
+// than with how many there are. the tree is kept balanced with rotations
+// as leaves are inserted and removed.
+// actors with unbounded bounds (planes) are kept outside the tree
+class Plane;
+
+class DynamicTree : public Broadphase
+{
+public:
+	DynamicTree(const float margin = 5.0f);
+	virtual ~DynamicTree() {};
+
+	virtual void addActor(PhysicsObject* actor);
+	virtual void removeActor(PhysicsObject* actor);
+
+	virtual void findPairs(const std::vector<PhysicsObject*>& actors, std::vector<CollisionPair>& pairs);
+
+	// scene queries, these return every actor whose bounds are hit. planes
+	// are tested exactly as they have no bounds
+	void queryPoint(const glm::vec2 point, std::vector<PhysicsObject*>& results);
+	void queryAabb(const glm::vec2 min, const glm::vec2 max, std::vector<PhysicsObject*>& results);
+	void raycast(const glm::vec2 origin, const glm::vec2 direction, const float maxDistance,
+		std::vector<PhysicsObject*>& results);
+
+	void setMargin(const float margin) { m_margin = margin; }
+	float getMargin() const { return m_margin; }
+
+	int getHeight() const { return m_root == NULL_NODE ? 0 : m_nodes[m_root].height; }
+	int getLeafCount() const { return (int)m_leaves.size(); }
+
+	// how many leaves were reinserted during the last findPairs
+	int getMovedCount() const { return m_movedCount; }
+
+protected:
+
+	static const int NULL_NODE = -1;
+
+	struct Node
+	{
+		// fat bounds for leaves, the union of the children otherwise
+		glm::vec2 min;
+		glm::vec2 max;
+
+		// the actor's current world bounds (leaves only)
+		glm::vec2 tightMin;
+		glm::vec2 tightMax;
+
+		// parent, or the next free node while on the free list
+		int parent;
+		int child1;
+		int child2;
+
+		// leaves are at height 0, free nodes at -1
+		int height;
+
+		PhysicsObject* actor;
+		bool moved;
+
+		// where the leaf is in m_leaves, or the actor in m_unbounded
+		int index;
+		bool unbounded;
+
+		bool isLeaf() const { return child1 == NULL_NODE; }
+	};
+
+	static uint64_t pairKey(const int a, const int b)
+	{
+		return a < b ? ((uint64_t)a << 32) | (uint64_t)b : ((uint64_t)b << 32) | (uint64_t)a;
+	}
+
+	int allocateNode();
+	void freeNode(const int node);
+
+	void insertLeaf(const int leaf);
+	void removeLeaf(const int leaf);
+	int balance(const int node);
+	void refit(int node);
+
+	void queryLeaves(const glm::vec2 min, const glm::vec2 max, std::vector<int>& leaves);
+	void queryPlane(const Plane* plane, std::vector<int>& leaves);
+
+	float m_margin;
+
+	std::vector<Node> m_nodes;
+	int m_root = NULL_NODE;
+	int m_freeList = NULL_NODE;
+
+	// every leaf in the tree
+	std::vector<int> m_leaves;
+
+	// actors that can't live in the tree. they still get a node so they
+	// can be found by id, it just never goes in the tree
+	std::vector<PhysicsObject*> m_unbounded;
+
+	// sorted keys of every pair of leaves whose fat bounds overlap
+	std::vector<uint64_t> m_pairKeys;
+
+	// leaves taken out of the tree since the last findPairs. their nodes
+	// aren't reused until their pairs have been dropped there
+	std::vector<int> m_removed;
+	void removePending();
+
+	// scratch buffers kept between steps
+	std::vector<int> m_moved;
+	std::vector<int> m_stack;
+	std::vector<int> m_hits;
+	std::vector<uint64_t> m_newKeys;
+	std::vector<uint64_t> m_scratchKeys;
+
+	int m_movedCount = 0;
+};
@@ -0,0 +1,90 @@
+#include "FrameGovernor.h"
+
+// each level keeps what the one before it gave up
+const FrameGovernor::Level FrameGovernor::LEVELS[LEVEL_COUNT] =
+{
+	// iterations, time step, sleep, reduced detail
+	{ 1.0f, 1.0f, 1.0f, false },
+	{ 0.75f, 1.0f, 2.0f, true },
+	{ 0.5f, 1.5f, 4.0f, true },
+	{ 0.25f, 2.0f, 8.0f, true },
+};
+
+void FrameGovernor::setBudget(const double milliseconds)
+{
+	m_budget = milliseconds;
+	m_overUpdates = 0;
+	m_underUpdates = 0;
+	if (!isEnabled())
+	{
+		setLevel(0);
+	}
+}
+
+bool FrameGovernor::addSample(const double milliseconds)
+{
+	if (!isEnabled())
+	{
+		return false;
+	}
+
+	m_cost += (milliseconds - m_cost) * SMOOTHING;
+	if (milliseconds > m_budget)
+	{
+		m_overBudgetUpdates++;
+	}
+
+	int level = m_level;
+	if (m_cost > m_budget)
+	{
+		m_underUpdates = 0;
+		if (++m_overUpdates >= DEGRADE_UPDATES && level < LEVEL_COUNT - 1)
+		{
+			level++;
+		}
+	}
+	else if (m_cost < m_budget * RECOVER_FRACTION)
+	{
+		m_overUpdates = 0;
+		if (++m_underUpdates >= RECOVER_UPDATES && level > 0)
+		{
+			level--;
+		}
+	}
+	else
+	{
+		m_overUpdates = 0;
+		m_underUpdates = 0;
+	}
+
+	if (level == m_level)
+	{
+		return false;
+	}
+	setLevel(level);
+	return true;
+}
+
+FrameGovernor::Stats FrameGovernor::getStats() const
+{
+	Stats stats;
+	stats.level = m_level;
+	stats.cost = m_cost;
+	stats.budget = m_budget;
+	stats.overBudgetUpdates = m_overBudgetUpdates;
+	stats.levelChanges = m_levelChanges;
+	return stats;
+}
+
+void FrameGovernor::setLevel(const int level)
+{
+	if (level != m_level)
+	{
+		m_level = level;
+		m_levelChanges++;
+	}
+
+	// the new level needs time to show in the cost before moving again
+	m_overUpdates = 0;
+	m_underUpdates = 0;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+// watches how long the physics takes each step and picks a quality
+// level to keep it inside a budget. the scene applies the level, the
+// governor only decides. it steps down a level when the smoothed cost has
+// been over budget for a while and back up once there's plenty of room,
+// so a single slow frame doesn't make the quality flicker
+class FrameGovernor
+{
+public:
+	// what the scene gives up at each level
+	struct Level
+	{
+		// the solver iterations, as a fraction of the ones the scene was given
+		float iterationScale;
+		// how much longer the fixed step gets
+		float timeStepScale;
+		// how much faster resting bodies away from the focus fall asleep
+		float sleepScale;
+		// drawing can use fewer segments and skip detail
+		bool reducedDetail;
+	};
+
+	static constexpr int LEVEL_COUNT = 4;
+	static const Level LEVELS[LEVEL_COUNT];
+
+	// what the governor has decided, and why
+	struct Stats
+	{
+		int level;
+		// the smoothed cost of a step and the budget, in milliseconds
+		double cost;
+		double budget;
+		// samples over budget, and how many times the level has changed
+		int overBudgetUpdates;
+		int levelChanges;
+	};
+
+	// 0 turns the governor off and goes back to full quality
+	void setBudget(const double milliseconds);
+	double getBudget() const { return m_budget; }
+	bool isEnabled() const { return m_budget > 0.0; }
+
+	// adds the average cost of the steps in an update, returns true if
+	// the level changed
+	bool addSample(const double milliseconds);
+
+	int getLevelIndex() const { return m_level; }
+	const Level& getLevel() const { return LEVELS[m_level]; }
+	Stats getStats() const;
+
+	// how quickly the smoothed cost follows the samples
+	static constexpr double SMOOTHING = 0.1;
+
+	// samples in a row over budget before dropping a level, and under
+	// RECOVER_FRACTION of it before going back up
+	static constexpr int DEGRADE_UPDATES = 10;
+	static constexpr int RECOVER_UPDATES = 120;
+	static constexpr double RECOVER_FRACTION = 0.6;
+
+private:
+	void setLevel(const int level);
+
+	double m_budget = 0.0;
+	double m_cost = 0.0;
+	int m_level = 0;
+	int m_overUpdates = 0;
+	int m_underUpdates = 0;
+	int m_overBudgetUpdates = 0;
+	int m_levelChanges = 0;
+};
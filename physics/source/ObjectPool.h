@@ -0,0 +1,136 @@
+#pragma once
+#include <vector>
+#include <new>
+#include <cassert>
+
+// hands out objects of one type from slabs of SLAB_SIZE at a time, so making
+// and freeing lots of them doesn't go through the global new and delete.
+// freed slots go on a free list and get reused first. the slabs are only
+// given back when the pool is destroyed, which destructs any objects that
+// are still out first
+template <typename T>
+class ObjectPool
+{
+public:
+	ObjectPool() {};
+	~ObjectPool()
+	{
+		// anything not on the free list is still alive
+		std::vector<bool> free(getCapacity(), false);
+		for (Slot* slot = m_free; slot != nullptr; slot = slot->next)
+		{
+			free[getSlotIndex(slot)] = true;
+		}
+		for (int i = 0; i < getCapacity() && m_count > 0; i++)
+		{
+			if (!free[i])
+			{
+				reinterpret_cast<T*>(m_slabs[i / SLAB_SIZE][i % SLAB_SIZE].storage)->~T();
+				m_count--;
+			}
+		}
+
+		for (auto slab : m_slabs)
+		{
+			::operator delete(slab);
+		}
+	}
+
+	ObjectPool(const ObjectPool&) = delete;
+	ObjectPool& operator=(const ObjectPool&) = delete;
+
+	static constexpr int SLAB_SIZE = 256;
+
+	// default constructs a T in a free slot
+	T* create()
+	{
+		if (m_free == nullptr)
+		{
+			addSlab();
+		}
+
+		Slot* slot = m_free;
+		m_free = slot->next;
+		m_count++;
+		return new (slot->storage) T();
+	}
+
+	// destructs an object made by create and frees its slot
+	void destroy(T* object)
+	{
+		assert(owns(object));
+		object->~T();
+
+		Slot* slot = reinterpret_cast<Slot*>(object);
+		slot->next = m_free;
+		m_free = slot;
+		m_count--;
+	}
+
+	// whether the object lives in one of this pool's slabs. this walks
+	// every slab, so it's only for asserts
+	bool owns(const T* object) const
+	{
+		const Slot* slot = reinterpret_cast<const Slot*>(object);
+		for (auto slab : m_slabs)
+		{
+			if (slot >= slab && slot < slab + SLAB_SIZE)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// makes sure there are slots for this many objects without allocating
+	void reserve(const int count)
+	{
+		while (getCapacity() < count)
+		{
+			addSlab();
+		}
+	}
+
+	// how many objects are out, and how many there is room for
+	int getCount() const { return m_count; }
+	int getCapacity() const { return (int)m_slabs.size() * SLAB_SIZE; }
+
+private:
+
+	// a free slot holds the next free slot, a used one holds the object
+	union Slot
+	{
+		Slot* next;
+		alignas(T) unsigned char storage[sizeof(T)];
+	};
+
+	// where a slot is across all the slabs, slab by slab
+	int getSlotIndex(const Slot* slot) const
+	{
+		for (int i = 0; i < (int)m_slabs.size(); i++)
+		{
+			if (slot >= m_slabs[i] && slot < m_slabs[i] + SLAB_SIZE)
+			{
+				return i * SLAB_SIZE + (int)(slot - m_slabs[i]);
+			}
+		}
+		return -1;
+	}
+
+	void addSlab()
+	{
+		Slot* slab = static_cast<Slot*>(::operator new(sizeof(Slot) * SLAB_SIZE));
+		m_slabs.push_back(slab);
+
+		// threaded backwards so the slots get used in address order
+		for (int i = SLAB_SIZE - 1; i >= 0; i--)
+		{
+			slab[i].next = m_free;
+			m_free = &slab[i];
+		}
+	}
+
+	std::vector<Slot*> m_slabs;
+	Slot* m_free = nullptr;
+	int m_count = 0;
+};
@@ -0,0 +1,74 @@
+#pragma once
+#include <glm/glm.hpp>
+#include "ActorHandle.h"
+
+enum ShapeTypes
+{
+	PLANE = 0,
+	SPHERE,
+	AABB,
+	BOX,
+	SHAPECOUNT
+};
+
+class PhysicsObject
+{
+protected:
+	PhysicsObject(ShapeTypes shapeID) : m_shapeID(shapeID) {};
+
+public:
+	virtual ~PhysicsObject() {};
+
+	virtual void fixedUpdate(glm::vec2 gravity, float timeStep) = 0;
+
+	// the world space axis aligned box that encloses this object, as of
+	// the last call to calculateBounds (done once per fixedUpdate)
+	void getBounds(glm::vec2& min, glm::vec2& max) const { min = m_boundsMin; max = m_boundsMax; }
+	glm::vec2 getBoundsMin() const { return m_boundsMin; }
+	glm::vec2 getBoundsMax() const { return m_boundsMax; }
+
+	// recalculates the cached world bounds
+	virtual void calculateBounds() = 0;
+
+	// branch free test of whether the cached bounds of two objects overlap
+	static bool boundsOverlap(const PhysicsObject* a, const PhysicsObject* b)
+	{
+		return (a->m_boundsMin.x <= b->m_boundsMax.x) & (b->m_boundsMin.x <= a->m_boundsMax.x) &
+			(a->m_boundsMin.y <= b->m_boundsMax.y) & (b->m_boundsMin.y <= a->m_boundsMax.y);
+	}
+
+	virtual ShapeTypes getShapeID() const{ return m_shapeID; }
+
+	// static objects are never moved by the simulation
+	virtual bool isStatic() const { return false; }
+
+	// sleeping objects have come to rest and are skipped until something
+	// wakes them
+	virtual bool isSleeping() const { return false; }
+
+	// whether the simulation has to do anything with this object
+	bool isActive() const { return !isStatic() && !isSleeping(); }
+
+	// the handle the scene gave this object, null when it isn't in one
+	ActorHandle getHandle() const { return m_handle; }
+
+	// where the scene's broadphase keeps this object, so it can find it
+	// again without searching. -1 when it isn't in one
+	int getBroadphaseId() const { return m_broadphaseId; }
+	void setBroadphaseId(const int id) { m_broadphaseId = id; }
+
+protected:
+	friend class PhysicsScene;
+	ActorHandle m_handle;
+
+	// whether a scene's create made this, so destroying it gives it back
+	// to the pool for its shape
+	bool m_pooled = false;
+
+	int m_broadphaseId = -1;
+
+	ShapeTypes m_shapeID;
+
+	glm::vec2 m_boundsMin = glm::vec2(0);
+	glm::vec2 m_boundsMax = glm::vec2(0);
+};
\ No newline at end of file
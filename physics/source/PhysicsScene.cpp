@@ -0,0 +1,1410 @@
+#include "PhysicsScene.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <list>
+#include "RigidBody.h"
+#include <iostream>
+#include "Sphere.h"
+#include "Plane.h"
+#include "Box.h"
+#include "Aabb.h"
+#include "DynamicTree.h"
+#include "CollisionDispatch.h"
+#include "AllocationCounter.h"
+#include "Profiler.h"
+#include "RenderState.h"
+#include <cassert>
+#include <glm/ext.hpp>
+
+// every collision function the scene knows about
+// the dispatch table is generated from this list at compile time, with
+// the (b, a) entries filled in automatically. pairs without a handler
+// (plane vs plane, box vs aabb) get nullptr and are skipped
+typedef CollisionHandlerList<
+	CollisionHandler<Sphere, Plane, &PhysicsScene::sphere2Plane>,
+	CollisionHandler<Sphere, Sphere, &PhysicsScene::sphere2Sphere>,
+	CollisionHandler<Box, Plane, &PhysicsScene::box2Plane>,
+	CollisionHandler<Box, Sphere, &PhysicsScene::box2Sphere>,
+	CollisionHandler<Box, Box, &PhysicsScene::box2Box>,
+	CollisionHandler<Aabb, Plane, &PhysicsScene::AABB2Plane>,
+	CollisionHandler<Aabb, Sphere, &PhysicsScene::AABB2Sphere>,
+	CollisionHandler<Aabb, Aabb, &PhysicsScene::AABB2AABB>
+> CollisionHandlers;
+
+// function pointer array for doing our collisions
+static constexpr CollisionHandlers::Table collisionFunctionArray = CollisionHandlers::makeTable();
+static constexpr CollisionHandlers::Coverage collisionCoverage = CollisionHandlers::makeCoverage();
+static_assert(collisionCoverage[PLANE * SHAPECOUNT + SPHERE] && collisionCoverage[SPHERE * SHAPECOUNT + PLANE] &&
+	!collisionCoverage[PLANE * SHAPECOUNT + PLANE], "collision dispatch table is wrong");
+
+PhysicsScene::PhysicsScene() : m_gravity(glm::vec2(0, 0)), m_timeStep(0.01f)
+{
+	m_baseTimeStep = m_timeStep;
+	m_baseIterations = m_solver.getIterations();
+}
+
+PhysicsScene::~PhysicsScene()
+{
+	for (auto pActor : m_actors)
+	{
+		freeActor(pActor);
+	}
+	delete m_broadphase;
+	delete m_threadPool;
+}
+
+void PhysicsScene::setThreadCount(const int threadCount)
+{
+	if (threadCount != getThreadCount())
+	{
+		delete m_threadPool;
+		m_threadPool = threadCount > 1 ? new ThreadPool(threadCount) : nullptr;
+		m_settledSteps = 0;
+	}
+}
+
+void PhysicsScene::setBroadphase(Broadphase* broadphase)
+{
+	if (broadphase != m_broadphase)
+	{
+		delete m_broadphase;
+		m_broadphase = broadphase;
+		m_settledSteps = 0;
+
+		if (m_broadphase != nullptr)
+		{
+			for (auto pActor : m_actors)
+			{
+				m_broadphase->addActor(pActor);
+			}
+		}
+	}
+}
+
+ActorHandle PhysicsScene::addActor(PhysicsObject* actor)
+{
+	if ((int)m_actors.size() >= m_maxActors)
+	{
+		freeActor(actor);
+		return ActorHandle();
+	}
+
+	// reuse a free slot if there is one, its generation was bumped when it
+	// was freed
+	int slot = m_freeSlot;
+	if (slot >= 0)
+	{
+		m_freeSlot = m_actorSlots[slot].index;
+	}
+	else
+	{
+		slot = (int)m_actorSlots.size();
+		m_actorSlots.push_back({ 1, 0 });
+	}
+	m_actorSlots[slot].index = (int)m_actors.size();
+	actor->m_handle.index = slot;
+	actor->m_handle.generation = m_actorSlots[slot].generation;
+
+	m_actors.push_back(actor);
+	m_settledSteps = 0;
+
+	// move the body's state into the scene's store
+	RigidBody* rigidBody = dynamic_cast<RigidBody*>(actor);
+	if (rigidBody != nullptr)
+	{
+		rigidBody->setStore(&m_bodies);
+	}
+
+	actor->calculateBounds();
+
+	if (m_broadphase != nullptr)
+	{
+		m_broadphase->addActor(actor);
+	}
+	return actor->m_handle;
+}
+
+int PhysicsScene::addActors(PhysicsObject* const* actors, const int count, ActorHandle* handles)
+{
+	int room = std::max(0, std::min(count, m_maxActors - (int)m_actors.size()));
+	m_actors.reserve(m_actors.size() + room);
+	m_actorSlots.reserve(m_actorSlots.size() + room);
+	m_bodies.reserve(m_bodies.getCount() + room);
+
+	for (int i = 0; i < count; i++)
+	{
+		ActorHandle handle = addActor(actors[i]);
+		if (handles != nullptr)
+		{
+			handles[i] = handle;
+		}
+	}
+	return room;
+}
+
+PhysicsObject* PhysicsScene::getActor(const ActorHandle handle) const
+{
+	if (handle.isNull() || handle.index >= m_actorSlots.size() ||
+		m_actorSlots[handle.index].generation != handle.generation)
+	{
+		return nullptr;
+	}
+	return m_actors[m_actorSlots[handle.index].index];
+}
+
+bool PhysicsScene::ownsActor(const PhysicsObject* actor) const
+{
+	return getActor(actor->m_handle) == actor;
+}
+
+void PhysicsScene::removeActor(PhysicsObject* actor)
+{
+	if (!ownsActor(actor))
+	{
+		return;
+	}
+
+	// swap the last actor into the gap
+	int slot = actor->m_handle.index;
+	int index = m_actorSlots[slot].index;
+	PhysicsObject* last = m_actors.back();
+	m_actors[index] = last;
+	m_actorSlots[last->m_handle.index].index = index;
+	m_actors.pop_back();
+
+	// bumping the generation invalidates every handle to this actor. 0 is
+	// skipped when it wraps so live slots never look null
+	m_actorSlots[slot].generation++;
+	if (m_actorSlots[slot].generation == 0)
+	{
+		m_actorSlots[slot].generation = 1;
+	}
+	m_actorSlots[slot].index = m_freeSlot;
+	m_freeSlot = slot;
+	actor->m_handle = ActorHandle();
+
+	m_settledSteps = 0;
+
+	RigidBody* rigidBody = dynamic_cast<RigidBody*>(actor);
+	if (rigidBody != nullptr && rigidBody->getStore() == &m_bodies)
+	{
+		// anything resting on the body has to fall, which is worked out
+		// for everything removed at once before the next step
+		RemovedBody removed;
+		rigidBody->getBounds(removed.min, removed.max);
+		removed.plane = rigidBody->getShapeID() == PLANE;
+		removed.normal = removed.plane ? static_cast<Plane*>(rigidBody)->getNormal() : glm::vec2(0);
+		removed.distance = removed.plane ? static_cast<Plane*>(rigidBody)->getDistance() : 0.0f;
+		m_removedBodies.push_back(removed);
+
+		rigidBody->setStore(nullptr);
+	}
+
+	if (m_broadphase != nullptr)
+	{
+		m_broadphase->removeActor(actor);
+	}
+}
+
+void PhysicsScene::removeActor(const ActorHandle handle)
+{
+	PhysicsObject* actor = getActor(handle);
+	if (actor != nullptr)
+	{
+		removeActor(actor);
+	}
+}
+
+void PhysicsScene::destroyActor(PhysicsObject* actor)
+{
+	removeActor(actor);
+	freeActor(actor);
+}
+
+void PhysicsScene::destroyActor(const ActorHandle handle)
+{
+	PhysicsObject* actor = getActor(handle);
+	if (actor != nullptr)
+	{
+		destroyActor(actor);
+	}
+}
+
+void PhysicsScene::flushDestroyQueue()
+{
+	// destroying an actor twice just finds a stale handle the second time
+	for (auto handle : m_destroyQueue)
+	{
+		destroyActor(handle);
+	}
+	m_destroyQueue.clear();
+}
+
+void PhysicsScene::freeActor(PhysicsObject* actor)
+{
+	// it wasn't made by create
+	if (!actor->m_pooled)
+	{
+		delete actor;
+		return;
+	}
+
+	// the pools check they own what they're given in debug builds
+	switch (actor->getShapeID())
+	{
+	case SPHERE:
+		m_spherePool.destroy(static_cast<Sphere*>(actor));
+		break;
+	case BOX:
+		m_boxPool.destroy(static_cast<Box*>(actor));
+		break;
+	case AABB:
+		m_aabbPool.destroy(static_cast<Aabb*>(actor));
+		break;
+	case PLANE:
+		m_planePool.destroy(static_cast<Plane*>(actor));
+		break;
+	default:
+		assert(false && "a pooled actor with no pool");
+		break;
+	}
+}
+
+void PhysicsScene::update(const float dt)
+{
+	PROFILE_ZONE("PhysicsScene::update");
+
+	// update physics at a fixed time step
+	m_accumulatedTime += dt;
+
+	Clock::time_point start = Clock::now();
+
+	m_updateStepCount = 0;
+	while (m_accumulatedTime >= m_timeStep && m_updateStepCount < m_maxSubsteps)
+	{
+		m_accumulatedTime -= m_timeStep;
+		step();
+		m_updateStepCount++;
+	}
+
+	// the governor judges what a step costs, an update that caught up on
+	// several steps isn't slower for it and one that ran none tells it
+	// nothing. the new level takes effect from the next update
+	if (m_updateStepCount > 0 &&
+		m_governor.addSample(getMilliseconds(start, Clock::now()) / m_updateStepCount))
+	{
+		applyQuality();
+	}
+
+	// keep the fraction of a step so the interpolation stays smooth
+	if (m_accumulatedTime >= m_timeStep)
+	{
+		int dropped = (int)(m_accumulatedTime / m_timeStep);
+		m_accumulatedTime -= dropped * m_timeStep;
+		m_droppedStepCount += dropped;
+	}
+}
+
+void PhysicsScene::setTimeStep(const float timeStep)
+{
+	m_baseTimeStep = timeStep;
+	applyQuality();
+}
+
+void PhysicsScene::setSolverIterations(const int iterations)
+{
+	m_baseIterations = iterations;
+	applyQuality();
+}
+
+void PhysicsScene::setStepBudget(const double milliseconds)
+{
+	m_governor.setBudget(milliseconds);
+	applyQuality();
+}
+
+void PhysicsScene::applyQuality()
+{
+	const FrameGovernor::Level& level = m_governor.getLevel();
+
+	// a step is never made longer than the cap, unless it already was
+	float maxTimeStep = m_baseTimeStep > MAX_GOVERNED_TIME_STEP ? m_baseTimeStep : MAX_GOVERNED_TIME_STEP;
+	m_timeStep = std::min(m_baseTimeStep * level.timeStepScale, maxTimeStep);
+
+	int iterations = (int)(m_baseIterations * level.iterationScale + 0.5f);
+	m_solver.setIterations(std::max(iterations, 1));
+}
+
+void PhysicsScene::writeRenderState(RenderState& state) const
+{
+	state.bodies.clear();
+	state.planes.clear();
+
+	for (auto pActor : m_actors)
+	{
+		if (pActor->getShapeID() == PLANE)
+		{
+			const Plane* plane = static_cast<const Plane*>(pActor);
+			state.planes.push_back({ plane->getNormal(), plane->getDistance() });
+			continue;
+		}
+
+		const RigidBody* body = static_cast<const RigidBody*>(pActor);
+		RenderState::Body drawn;
+		drawn.shape = body->getShapeID();
+		drawn.previousPosition = body->getInterpolatedPosition(0.0f);
+		drawn.position = body->getPosition();
+		drawn.previousRotation = body->getInterpolatedRotation(0.0f);
+		drawn.rotation = body->getRotation();
+		drawn.color = body->getColor();
+
+		switch (drawn.shape)
+		{
+		case SPHERE:
+			drawn.size = glm::vec2(static_cast<const Sphere*>(body)->getRadius());
+			break;
+		case BOX:
+			drawn.size = static_cast<const Box*>(body)->getExtents();
+			break;
+		case AABB:
+			drawn.size = static_cast<const Aabb*>(body)->getExtents();
+			break;
+		default:
+			drawn.size = glm::vec2(0);
+			break;
+		}
+		state.bodies.push_back(drawn);
+	}
+
+	RenderState::Stats& stats = state.stats;
+	stats.actorCount = getActorCount();
+	stats.pairCount = getPairCount();
+	stats.contactCount = (int)m_contacts.size();
+	stats.updateStepCount = m_updateStepCount;
+	stats.maxSubsteps = m_maxSubsteps;
+	stats.droppedStepCount = m_droppedStepCount;
+	stats.solverIterations = getSolverIterations();
+	stats.timeStep = m_timeStep;
+	stats.stepTimings = m_stepTimings;
+	stats.governor = m_governor.getStats();
+	stats.reducedDetail = m_governor.getLevel().reducedDetail;
+	stats.stepAllocations = m_stepSnapshot;
+
+	state.interpolationAlpha = getInterpolationAlpha();
+	state.stepCount = m_stepCount;
+}
+
+void PhysicsScene::step()
+{
+	PROFILE_ZONE("PhysicsScene::step");
+
+	// actors queued for destruction go between steps
+	flushDestroyQueue();
+	fixUpRemovedBodies();
+	wakeMovedBodies();
+
+	AllocationCounter::ScopedTag tag(AllocationCounter::PHYSICS);
+	bool tracking = AllocationCounter::isTracking();
+	AllocationCounter::Snapshot snapshot;
+	if (tracking)
+	{
+		snapshot = AllocationCounter::getSnapshot();
+	}
+
+#if defined(PHYSICS_COUNT_ALLOCATIONS)
+	size_t allocations = countAllocations();
+#endif
+
+	Clock::time_point start = Clock::now();
+
+	{
+		PROFILE_ZONE("integrate");
+
+		// drawing blends from where the bodies were before this step
+		m_bodies.savePrevious();
+
+		// integrate every body in one pass over the store
+		m_bodies.integrate(m_gravity, m_timeStep);
+
+		// sleeping bodies haven't moved
+		for (auto pActor : m_actors)
+		{
+			if (!pActor->isSleeping())
+			{
+				pActor->calculateBounds();
+			}
+		}
+	}
+
+	Clock::time_point integrated = Clock::now();
+	m_stepTimings.integrate = getMilliseconds(start, integrated);
+
+	partitionActors();
+	Clock::time_point partitioned = Clock::now();
+
+	// checkForCollison times the broadphase itself, the rest of it is
+	// the narrowphase
+	checkForCollison();
+	PROFILE_COUNT(PAIRS_TESTED, (int64_t)m_pairs.size());
+	PROFILE_COUNT(CONTACTS_FOUND, (int64_t)m_contacts.size());
+
+	Clock::time_point collided = Clock::now();
+	m_stepTimings.narrowphase = getMilliseconds(partitioned, collided) - m_stepTimings.pairs;
+	m_stepTimings.pairs += getMilliseconds(integrated, partitioned);
+
+	buildIslands();
+	resolveContacts();
+
+	Clock::time_point resolved = Clock::now();
+	m_stepTimings.response = getMilliseconds(collided, resolved);
+
+	updateSleeping();
+	m_stepTimings.sleeping = getMilliseconds(resolved, Clock::now());
+
+#if defined(PHYSICS_COUNT_ALLOCATIONS)
+	checkAllocations(countAllocations() - allocations);
+#endif
+
+	if (tracking)
+	{
+		// the step and its workers charge everything to PHYSICS, the other
+		// tags are whatever other threads did meanwhile
+		m_stepSnapshot = AllocationCounter::getSnapshot().since(snapshot).only(AllocationCounter::PHYSICS);
+		if (m_allocationLog != nullptr)
+		{
+			AllocationCounter::writeCsv(m_allocationLog, "step", m_stepCount, m_stepSnapshot);
+		}
+	}
+	m_stepCount++;
+}
+
+size_t PhysicsScene::countAllocations() const
+{
+	size_t allocations = AllocationCounter::getThreadCount();
+	if (m_threadPool != nullptr)
+	{
+		allocations += m_threadPool->getWorkerAllocations();
+	}
+	return allocations;
+}
+
+void PhysicsScene::checkAllocations(const size_t allocations)
+{
+	m_stepAllocations = allocations;
+
+	// more pairs or contacts than ever before can grow the buffers. the
+	// broadphase keeps structures that grow with the scene too, like the
+	// tree and its list of fat pairs, so it allocating counts as growth
+	bool grown = m_pairs.size() > m_maxPairs || m_contacts.size() > m_maxContacts ||
+		m_solver.getBatchCount() > m_maxBatches || m_broadphaseAllocations > 0;
+	m_broadphaseAllocations = 0;
+	m_maxPairs = std::max(m_maxPairs, m_pairs.size());
+	m_maxContacts = std::max(m_maxContacts, m_contacts.size());
+	m_maxBatches = std::max(m_maxBatches, m_solver.getBatchCount());
+
+	if (m_settledSteps < SETTLE_STEPS)
+	{
+		m_settledSteps = grown || allocations > 0 ? 0 : m_settledSteps + 1;
+		return;
+	}
+
+	// once it has settled the buffers only grow along with the pairs and
+	// contacts, otherwise they're already big enough
+	assert((allocations == 0 || grown) && "the physics step allocated after the scene settled");
+	if (grown)
+	{
+		m_settledSteps = 0;
+	}
+}
+
+void PhysicsScene::partitionActors()
+{
+	PROFILE_ZONE("partitionActors");
+
+	m_dynamicActors.clear();
+	m_staticActors.clear();
+
+	// bodies waking and sleeping move between the two, so both get room
+	// for everything
+	m_dynamicActors.reserve(m_actors.size());
+	m_staticActors.reserve(m_actors.size());
+
+	for (auto pActor : m_actors)
+	{
+		if (!pActor->isActive())
+		{
+			m_staticActors.push_back(pActor);
+		}
+		else
+		{
+			m_dynamicActors.push_back(pActor);
+		}
+	}
+}
+
+void PhysicsScene::checkForCollison()
+{
+	PROFILE_ZONE("checkForCollison");
+	Clock::time_point start = Clock::now();
+
+	m_pairs.clear();
+	m_contacts.clear();
+
+	{
+		PROFILE_ZONE("broadphase");
+
+		if (m_broadphase != nullptr)
+		{
+#if defined(PHYSICS_COUNT_ALLOCATIONS)
+			size_t allocations = countAllocations();
+			m_broadphase->findPairs(m_actors, m_pairs);
+			m_broadphaseAllocations = countAllocations() - allocations;
+#else
+			m_broadphase->findPairs(m_actors, m_pairs);
+#endif
+		}
+		else
+		{
+			int dynamicCount = (int)m_dynamicActors.size();
+
+			// need to check for collisions against all objects except this one
+			for (int outer = 0; outer < dynamicCount; outer++)
+			{
+				for (int inner = outer + 1; inner < dynamicCount; inner++)
+				{
+					m_pairs.push_back({ m_dynamicActors[outer], m_dynamicActors[inner] });
+				}
+
+				// static actors only need testing against dynamic ones
+				for (auto pStatic : m_staticActors)
+				{
+					m_pairs.push_back({ pStatic, m_dynamicActors[outer] });
+				}
+			}
+		}
+	}
+
+	m_stepTimings.pairs = getMilliseconds(start, Clock::now());
+
+	int pairCount = (int)m_pairs.size();
+	int chunkCount = 1;
+	if (m_threadPool != nullptr)
+	{
+		chunkCount = pairCount / MIN_PAIRS_PER_CHUNK;
+		if (chunkCount > m_threadPool->getThreadCount() * 4)
+		{
+			chunkCount = m_threadPool->getThreadCount() * 4;
+		}
+	}
+
+	if (chunkCount <= 1)
+	{
+		narrowphase(0, pairCount, m_contacts);
+		return;
+	}
+
+	// the collision functions only read the bodies, so the chunks can run
+	// at the same time
+	if ((int)m_chunkContacts.size() < chunkCount)
+	{
+		m_chunkContacts.resize(chunkCount);
+	}
+	m_chunkCount = chunkCount;
+
+	// a pair makes at most one contact, so with room for every pair the
+	// chunks never grow their buffers on the other threads
+	for (int i = 0; i < chunkCount; i++)
+	{
+		int begin = (int)((long long)pairCount * i / chunkCount);
+		int end = (int)((long long)pairCount * (i + 1) / chunkCount);
+		std::vector<Contact>& contacts = m_chunkContacts[i];
+		if ((int)contacts.capacity() < end - begin)
+		{
+			contacts.reserve(std::max((size_t)(end - begin), contacts.capacity() * 2));
+		}
+	}
+	m_threadPool->parallelFor(chunkCount, &PhysicsScene::narrowphaseChunk, this);
+
+	for (int i = 0; i < chunkCount; i++)
+	{
+		m_contacts.insert(m_contacts.end(), m_chunkContacts[i].begin(), m_chunkContacts[i].end());
+	}
+}
+
+void PhysicsScene::narrowphaseChunk(void* scene, int chunk)
+{
+	PhysicsScene* physicsScene = (PhysicsScene*)scene;
+
+	int pairCount = (int)physicsScene->m_pairs.size();
+	int begin = (int)((long long)pairCount * chunk / physicsScene->m_chunkCount);
+	int end = (int)((long long)pairCount * (chunk + 1) / physicsScene->m_chunkCount);
+
+	std::vector<Contact>& contacts = physicsScene->m_chunkContacts[chunk];
+	contacts.clear();
+	physicsScene->narrowphase(begin, end, contacts);
+}
+
+void PhysicsScene::narrowphase(const int begin, const int end, std::vector<Contact>& contacts)
+{
+	PROFILE_ZONE("narrowphase");
+
+	for (int i = begin; i < end; i++)
+	{
+		const CollisionPair& pair = m_pairs[i];
+
+		// skip static pairs and pairs whose bounds don't touch before
+		// paying for the collision function
+		if (!canCollide(pair.a, pair.b) || !PhysicsObject::boundsOverlap(pair.a, pair.b))
+		{
+			continue;
+		}
+
+		int shapeId1 = pair.a->getShapeID();
+		int shapeId2 = pair.b->getShapeID();
+
+		// using function pointers
+		int functionIdx = (shapeId1 * ShapeTypes::SHAPECOUNT) + shapeId2;
+		CollisionFunction collisionFunctionPtr = collisionFunctionArray[functionIdx];
+		if (collisionFunctionPtr != nullptr)
+		{
+			// did the collision occur?
+			Contact contact;
+#if defined(PHYSICS_COUNT_ALLOCATIONS) && !defined(NDEBUG)
+			size_t allocations = AllocationCounter::getThreadCount();
+#endif
+			bool colliding = collisionFunctionPtr(pair.a, pair.b, contact);
+
+			// the collision functions run for every pair every step, they
+			// mustn't touch the heap
+			assert(AllocationCounter::getThreadCount() == allocations && "a collision function allocated");
+			if (colliding)
+			{
+				contacts.push_back(contact);
+			}
+		}
+	}
+}
+
+void PhysicsScene::resolveContacts()
+{
+	PROFILE_ZONE("resolveContacts");
+	m_solver.solve(m_bodies, m_contacts, m_islands, m_threadPool);
+}
+
+void PhysicsScene::setSleepingEnabled(const bool enabled)
+{
+	m_sleepingEnabled = enabled;
+
+	if (!enabled)
+	{
+		for (int i = 0; i < m_bodies.getCount(); i++)
+		{
+			m_bodies.getOwner(i)->wake();
+		}
+	}
+}
+
+void PhysicsScene::buildIslands()
+{
+	PROFILE_ZONE("buildIslands");
+
+	// join up the bodies that touch. kinematic bodies are left out or
+	// everything resting on the ground would be one big island
+	m_islands.reset(m_bodies.getCount());
+	for (auto& contact : m_contacts)
+	{
+		if (!m_bodies.m_kinematic[contact.bodyA] && !m_bodies.m_kinematic[contact.bodyB])
+		{
+			m_islands.join(contact.bodyA, contact.bodyB);
+		}
+	}
+}
+
+void PhysicsScene::updateSleeping()
+{
+	PROFILE_ZONE("updateSleeping");
+
+	if (!m_sleepingEnabled)
+	{
+		return;
+	}
+
+	int count = m_bodies.getCount();
+
+	// while the governor is lowering the quality, resting bodies away from
+	// the focus count down to sleep faster so their pairs drop out of the
+	// narrowphase sooner
+	float sleepScale = m_governor.getLevel().sleepScale;
+	float focusRadiusSq = m_focusRadius * m_focusRadius;
+
+	// how long has each body been slow enough to sleep
+	for (int i = 0; i < count; i++)
+	{
+		if (m_bodies.m_kinematic[i] || m_bodies.m_asleep[i])
+		{
+			continue;
+		}
+
+		float sleepRate = 1.0f;
+		if (sleepScale > 1.0f)
+		{
+			glm::vec2 offset = glm::vec2(m_bodies.m_positionX[i], m_bodies.m_positionY[i]) - m_focusCenter;
+			if (m_focusRadius <= 0.0f || glm::dot(offset, offset) > focusRadiusSq)
+			{
+				sleepRate = sleepScale;
+			}
+		}
+
+		float speedSq = m_bodies.m_velocityX[i] * m_bodies.m_velocityX[i] +
+			m_bodies.m_velocityY[i] * m_bodies.m_velocityY[i];
+		if (speedSq > SLEEP_LINEAR_TOLERANCE * SLEEP_LINEAR_TOLERANCE ||
+			std::fabs(m_bodies.m_angularVelocity[i]) > SLEEP_ANGULAR_TOLERANCE)
+		{
+			m_bodies.m_sleepTime[i] = 0;
+		}
+		else
+		{
+			m_bodies.m_sleepTime[i] += m_timeStep * sleepRate;
+		}
+	}
+
+	// an island is ready to sleep when all of its awake bodies are,
+	// the bodies already asleep don't hold it back
+	m_islandSleepTime.assign(count, FLT_MAX);
+	for (int i = 0; i < count; i++)
+	{
+		if (!m_bodies.m_kinematic[i] && !m_bodies.m_asleep[i])
+		{
+			int island = m_islands.find(i);
+			m_islandSleepTime[island] = std::fminf(m_islandSleepTime[island], m_bodies.m_sleepTime[i]);
+		}
+	}
+
+	for (int i = 0; i < count; i++)
+	{
+		if (m_bodies.m_kinematic[i])
+		{
+			continue;
+		}
+
+		bool sleep = m_islandSleepTime[m_islands.find(i)] >= TIME_TO_SLEEP;
+		if (sleep != (m_bodies.m_asleep[i] != 0))
+		{
+			// sleeping bodies only wake up here when an awake body has
+			// touched their island
+			m_bodies.getOwner(i)->setSleeping(sleep);
+		}
+	}
+}
+
+void PhysicsScene::wakeTouching(const RigidBody* body)
+{
+	// awake bodies it was holding up start counting down to sleep again
+	int index = body->getStoreIndex();
+	for (auto& contact : m_contacts)
+	{
+		if (contact.bodyA == index || contact.bodyB == index)
+		{
+			int other = contact.bodyA == index ? contact.bodyB : contact.bodyA;
+			m_bodies.m_sleepTime[other] = 0;
+		}
+	}
+
+	// sleeping bodies have no contacts, so go by their bounds
+	const Plane* plane = body->getShapeID() == PLANE ? static_cast<const Plane*>(body) : nullptr;
+	int count = m_bodies.getCount();
+	for (int i = 0; i < count; i++)
+	{
+		if (!m_bodies.m_asleep[i] || i == index)
+		{
+			continue;
+		}
+
+		RigidBody* other = m_bodies.getOwner(i);
+		glm::vec2 min, max;
+		other->getBounds(min, max);
+		if (plane != nullptr ? plane->overlaps(min, max) : PhysicsObject::boundsOverlap(body, other))
+		{
+			other->wake();
+		}
+	}
+}
+
+void PhysicsScene::wakeMovedBodies()
+{
+	for (auto body : m_bodies.m_moved)
+	{
+		// the bounds are still from before it moved
+		wakeTouching(body);
+		body->calculateBounds();
+		wakeTouching(body);
+	}
+	m_bodies.clearMoved();
+}
+
+void PhysicsScene::fixUpRemovedBodies()
+{
+	if (!m_bodies.haveRowsChanged())
+	{
+		return;
+	}
+
+	// the contacts are from the last step. awake bodies a removed one was
+	// holding up start counting down to sleep again
+	size_t kept = 0;
+	for (auto contact : m_contacts)
+	{
+		int a = m_bodies.getNewRow(contact.bodyA);
+		int b = m_bodies.getNewRow(contact.bodyB);
+		if (a < 0 || b < 0)
+		{
+			if (a >= 0)
+			{
+				m_bodies.m_sleepTime[a] = 0;
+			}
+			if (b >= 0)
+			{
+				m_bodies.m_sleepTime[b] = 0;
+			}
+			continue;
+		}
+		contact.bodyA = a;
+		contact.bodyB = b;
+		m_contacts[kept++] = contact;
+	}
+	m_contacts.resize(kept);
+	m_solver.remapBodies(m_bodies);
+
+	// sleeping bodies have no contacts, so go by their bounds
+	if (!m_removedBodies.empty())
+	{
+		int count = m_bodies.getCount();
+		for (int i = 0; i < count; i++)
+		{
+			if (!m_bodies.m_asleep[i])
+			{
+				continue;
+			}
+
+			RigidBody* body = m_bodies.getOwner(i);
+			glm::vec2 min, max;
+			body->getBounds(min, max);
+			for (auto& removed : m_removedBodies)
+			{
+				if (removed.plane ? Plane::overlaps(removed.normal, removed.distance, min, max) :
+					!(max.x < removed.min.x || min.x > removed.max.x || max.y < removed.min.y || min.y > removed.max.y))
+				{
+					body->wake();
+					break;
+				}
+			}
+		}
+		m_removedBodies.clear();
+	}
+
+	m_bodies.commitRows();
+}
+
+void PhysicsScene::queryPoint(const glm::vec2 point, std::vector<PhysicsObject*>& results)
+{
+	queryAabb(point, point, results);
+}
+
+void PhysicsScene::queryAabb(const glm::vec2 min, const glm::vec2 max, std::vector<PhysicsObject*>& results)
+{
+	DynamicTree* tree = dynamic_cast<DynamicTree*>(m_broadphase);
+	if (tree != nullptr)
+	{
+		tree->queryAabb(min, max, results);
+		return;
+	}
+
+	for (auto pActor : m_actors)
+	{
+		glm::vec2 actorMin, actorMax;
+		pActor->getBounds(actorMin, actorMax);
+		if (!(max.x < actorMin.x || min.x > actorMax.x || max.y < actorMin.y || min.y > actorMax.y))
+		{
+			results.push_back(pActor);
+		}
+	}
+}
+
+void PhysicsScene::raycast(const glm::vec2 origin, const glm::vec2 direction, const float maxDistance,
+	std::vector<PhysicsObject*>& results)
+{
+	DynamicTree* tree = dynamic_cast<DynamicTree*>(m_broadphase);
+	if (tree != nullptr)
+	{
+		tree->raycast(origin, direction, maxDistance, results);
+		return;
+	}
+
+	// a ray with no direction doesn't hit anything
+	if (direction.x == 0.0f && direction.y == 0.0f)
+	{
+		return;
+	}
+
+	glm::vec2 invDir = 1.0f / glm::normalize(direction);
+	for (auto pActor : m_actors)
+	{
+		glm::vec2 actorMin, actorMax;
+		pActor->getBounds(actorMin, actorMax);
+
+		// slab test
+		glm::vec2 t1 = (actorMin - origin) * invDir;
+		glm::vec2 t2 = (actorMax - origin) * invDir;
+		float tMin = fmaxf(fminf(t1.x, t2.x), fminf(t1.y, t2.y));
+		float tMax = fminf(fmaxf(t1.x, t2.x), fmaxf(t1.y, t2.y));
+		if (tMax >= fmaxf(tMin, 0.0f) && tMin <= maxDistance)
+		{
+			results.push_back(pActor);
+		}
+	}
+}
+
+
+// ---------------------------------------------------------
+// colision detection functions
+// ---------------------------------------------------------
+
+// text collision between a sphere and a plane
+bool PhysicsScene::sphere2Plane(Sphere* sphere, Plane* plane, Contact& contact)
+{
+	glm::vec2 collisionNormal = plane->getNormal();
+	float sphereToPlane = glm::dot(
+		sphere->getPosition(),
+		plane->getNormal()) - plane->getDistance();
+
+	// if we are behind plane then we flip the normal
+	if (sphereToPlane < 0)
+	{
+		collisionNormal *= -1;
+		sphereToPlane *= -1;
+	}
+
+	float intersection = sphere->getRadius() - sphereToPlane;
+
+	if (intersection > 0)
+	{
+		contact.bodyA = sphere->getStoreIndex();
+		contact.bodyB = plane->getStoreIndex();
+		contact.normal = -collisionNormal;
+		contact.points[0] = sphere->getPosition() + (collisionNormal * -sphere->getRadius());
+		contact.pointCount = 1;
+		contact.penetration = intersection;
+		contact.featureId = 0;
+		return true;
+	}
+	return false;
+}
+
+// test collision between 2 spheres
+bool PhysicsScene::sphere2Sphere(Sphere* sphere1, Sphere* sphere2, Contact& contact)
+{
+	// vector from 1 to 2
+	glm::vec2 delta = sphere2->getPosition() - sphere1->getPosition();
+	// squared distance of delta
+	float sqrDist = glm::dot(delta, delta);
+
+	// combined radii
+	float r = sphere1->getRadius() + sphere2->getRadius();
+
+	if (sqrDist <= (r * r))
+	{
+		float distance = std::sqrt(sqrDist);
+
+		// spheres right on top of each other get pushed apart sideways
+		glm::vec2 normal = distance > 0 ? delta / distance : glm::vec2(1, 0);
+
+		contact.bodyA = sphere1->getStoreIndex();
+		contact.bodyB = sphere2->getStoreIndex();
+		contact.normal = normal;
+		contact.penetration = r - distance;
+
+		// halfway through the overlap
+		contact.points[0] = sphere1->getPosition() + normal * (sphere1->getRadius() - contact.penetration * 0.5f);
+		contact.pointCount = 1;
+		contact.featureId = 0;
+		return true;
+	}
+	return false;
+}
+
+// test collision between a box and a plane
+bool PhysicsScene::box2Plane(Box* box, Plane* plane, Contact& contact)
+{
+	int numContacts = 0;
+	float penetration = 0;
+
+	// the corners touching the plane and how deep they are
+	glm::vec2 corners[4];
+	float depths[4];
+	uint32_t featureId = 0;
+
+	// which side is the centre of mass on?
+	glm::vec2 planeOrigin = plane->getNormal() * plane->getDistance();
+	float comFromPlane = glm::dot(box->getPosition() - planeOrigin,
+		plane->getNormal());
+
+	// check all four corners to see if we've hit the plane
+	int corner = 0;
+	for (float x = -box->getExtents().x; x < box->getWidth(); x += box->getWidth())
+	{
+		for (float y = -box->getExtents().y; y < box->getHeight(); y += box->getHeight(), corner++)
+		{
+			// get the position of the corner in world space
+			glm::vec2 p = box->getPosition() + x * box->getLocalX() +
+				y * box->getLocalY();
+
+			float distFromPlane = glm::dot(p - planeOrigin, plane->getNormal());
+
+			// this is the total velocity of the point
+			float velocityIntoPlane = glm::dot(box->getVelocity() + box->getAngularVelocity() *
+				(-y * box->getLocalX() + x * box->getLocalY()), plane->getNormal());
+
+			// if this corner is on the opposite side from the COM,
+			// and moving further in, we need to resolve the collision
+			if ((distFromPlane > 0 && comFromPlane < 0 && velocityIntoPlane >= 0) ||
+				(distFromPlane < 0 && comFromPlane > 0 && velocityIntoPlane <= 0))
+			{
+				corners[numContacts] = p;
+				depths[numContacts] = std::fabs(distFromPlane);
+				featureId |= 1 << corner;
+				numContacts++;
+
+				penetration = std::fmaxf(penetration, std::fabs(distFromPlane));
+			}
+		}
+	}
+	// we've had a hit - typically only two corners can contact
+	if (numContacts > 0)
+	{
+		contact.bodyA = box->getStoreIndex();
+		contact.bodyB = plane->getStoreIndex();
+
+		// from the box into the plane
+		contact.normal = comFromPlane >= 0 ? -plane->getNormal() : plane->getNormal();
+		contact.penetration = penetration;
+		contact.featureId = featureId;
+
+		// keep the two deepest corners
+		for (int i = 0; i < numContacts && i < 2; i++)
+		{
+			int deepest = i;
+			for (int j = i + 1; j < numContacts; j++)
+			{
+				if (depths[j] > depths[deepest])
+				{
+					deepest = j;
+				}
+			}
+			std::swap(corners[i], corners[deepest]);
+			std::swap(depths[i], depths[deepest]);
+			contact.points[i] = corners[i];
+		}
+		contact.pointCount = numContacts < 2 ? numContacts : 2;
+		return true;
+	}
+	return false;
+}
+
+// test collision between a box and a sphere
+bool PhysicsScene::box2Sphere(Box* box, Sphere* sphere, Contact& contact)
+{
+	glm::vec2 spherePos = sphere->getPosition() - box->getPosition();
+	float w2 = box->getWidth() / 2, h2 = box->getHeight() / 2;
+	int numContacts = 0;
+	glm::vec2 localContact(0, 0); // contact is in our box coordinates
+	uint32_t featureId = 0;
+
+	// check the four corners to see if any of them are inside the sphere
+	int corner = 0;
+	for (float x = -w2; x <= w2; x += box->getWidth())
+	{
+		for (float y = -h2; y <= h2; y += box->getHeight(), corner++)
+		{
+			glm::vec2 p = x * box->getLocalX() + y * box->getLocalY();
+			glm::vec2 dp = p - spherePos;
+			if (dp.x * dp.x + dp.y * dp.y < sphere->getRadius() * sphere->getRadius())
+			{
+				numContacts++;
+				localContact += glm::vec2(x, y);
+				featureId |= 1 << corner;
+			}
+		}
+	}
+	// the normal of the last edge the sphere is against, if any
+	glm::vec2 direction(0, 0);
+	bool hitEdge = false;
+
+	// get the local position of the sphere centre
+	glm::vec2 localPos(glm::dot(box->getLocalX(), spherePos),
+		glm::dot(box->getLocalY(), spherePos));
+
+	// the edges go in the bits above the corners
+	if (localPos.y < h2 && localPos.y > -h2)
+	{
+		if (localPos.x > 0 && localPos.x < w2 + sphere->getRadius())
+		{
+			numContacts++;
+			localContact += glm::vec2(w2, localPos.y);
+			direction = box->getLocalX();
+			hitEdge = true;
+			featureId |= 1 << 4;
+		}
+		if (localPos.x < 0 && localPos.x > -(w2 + sphere->getRadius()))
+		{
+			numContacts++;
+			localContact += glm::vec2(-w2, localPos.y);
+			direction = -box->getLocalX();
+			hitEdge = true;
+			featureId |= 1 << 5;
+		}
+	}
+	if (localPos.x < w2 && localPos.x > -w2)
+	{
+		if (localPos.y > 0 && localPos.y < h2 + sphere->getRadius())
+		{
+			numContacts++;
+			localContact += glm::vec2(localPos.x, h2);
+			direction = box->getLocalY();
+			hitEdge = true;
+			featureId |= 1 << 6;
+		}
+		if (localPos.y < 0 && localPos.y > -(h2 + sphere->getRadius()))
+		{
+			numContacts++;
+			localContact += glm::vec2(localPos.x, -h2);
+			direction = -box->getLocalY();
+			hitEdge = true;
+			featureId |= 1 << 7;
+		}
+	}
+	bool colliding = false;
+	if (numContacts > 0)
+	{
+		// average, and convert back into world coords
+		glm::vec2 point = box->getPosition() + (1.0f / numContacts) *
+			(box->getLocalX() * localContact.x + box->getLocalY() * localContact.y);
+
+		// with the contact point we can find the penetration
+		float pen = sphere->getRadius() - glm::length(point -
+			sphere->getPosition());
+
+		contact.bodyA = box->getStoreIndex();
+		contact.bodyB = sphere->getStoreIndex();
+
+		// the normal of the edge we hit, or towards the sphere for a corner
+		glm::vec2 toSphere = sphere->getPosition() - point;
+		if (hitEdge)
+		{
+			contact.normal = direction;
+		}
+		else if (glm::dot(toSphere, toSphere) > 0)
+		{
+			contact.normal = glm::normalize(toSphere);
+		}
+		else
+		{
+			contact.normal = glm::normalize(sphere->getPosition() - box->getPosition());
+		}
+		contact.points[0] = point;
+		contact.pointCount = 1;
+		contact.penetration = pen;
+		contact.featureId = featureId;
+		colliding = true;
+	}
+	return colliding;
+}
+
+// adds the corners of box that are inside other to corners
+static void findCornersInside(const Box* box, const Box* other, glm::vec2* corners, int& count)
+{
+	glm::vec2 otherPosition = other->getPosition();
+	glm::vec2 otherLocalX = other->getLocalX();
+	glm::vec2 otherLocalY = other->getLocalY();
+
+	for (float x = -1; x <= 1; x += 2)
+	{
+		for (float y = -1; y <= 1; y += 2)
+		{
+			glm::vec2 p = box->getPosition() + x * box->getExtents().x * box->getLocalX() +
+				y * box->getExtents().y * box->getLocalY();
+
+			glm::vec2 local(glm::dot(p - otherPosition, otherLocalX), glm::dot(p - otherPosition, otherLocalY));
+			if (std::fabs(local.x) <= other->getExtents().x && std::fabs(local.y) <= other->getExtents().y)
+			{
+				corners[count++] = p;
+			}
+		}
+	}
+}
+
+// test collision between 2 boxes
+bool PhysicsScene::box2Box(Box* box1, Box* box2, Contact& contact)
+{
+	glm::vec2 normal(0, 0);
+	glm::vec2 contactForce1(0, 0), contactForce2(0, 0);
+	glm::vec2 point(0, 0);
+	int numContacts = 0;
+	uint32_t featureId = 0;
+
+	// corners of box2 inside box1 go in the first bit, box1's in box2
+	// go in the second
+	if (box1->checkBoxCorners(*box2, point, numContacts, normal, contactForce1))
+	{
+		featureId |= 1;
+	}
+	if (box2->checkBoxCorners(*box1, point, numContacts,
+		normal, contactForce2))
+	{
+		normal = -normal;
+		featureId |= 2;
+	}
+
+	if (numContacts > 0)
+	{
+		contact.bodyA = box1->getStoreIndex();
+		contact.bodyB = box2->getStoreIndex();
+		contact.normal = normal;
+		contact.penetration = glm::length(contactForce1 - contactForce2);
+
+		// use the corners inside the other box as the points, keeping the
+		// two furthest apart so a resting box gets one at each end
+		glm::vec2 corners[8];
+		int cornerCount = 0;
+		findCornersInside(box1, box2, corners, cornerCount);
+		findCornersInside(box2, box1, corners, cornerCount);
+
+		if (cornerCount == 0)
+		{
+			contact.points[0] = point / float(numContacts);
+			contact.pointCount = 1;
+		}
+		else
+		{
+			int furthest = 0;
+			for (int i = 1; i < cornerCount; i++)
+			{
+				if (glm::dot(corners[i] - corners[0], corners[i] - corners[0]) >
+					glm::dot(corners[furthest] - corners[0], corners[furthest] - corners[0]))
+				{
+					furthest = i;
+				}
+			}
+			contact.points[0] = corners[0];
+			contact.points[1] = corners[furthest];
+			contact.pointCount = furthest != 0 ? 2 : 1;
+		}
+		contact.featureId = featureId;
+		return true;
+	}
+	return false;
+}
+
+// test collision between an axis aligned bounding box and a plane
+bool PhysicsScene::AABB2Plane(Aabb* aabb, Plane* plane, Contact& contact)
+{
+	glm::vec2 collisionNormal = plane->getNormal();
+
+	float cornerOffsets[4];
+	bool signs[4];
+
+	for (int i = 0; i < 4; i++)
+	{
+		cornerOffsets[i] = glm::dot(aabb->getCorner(i + 1), collisionNormal) - plane->getDistance();
+		signs[i] = std::signbit(cornerOffsets[i]);
+	}
+
+	if (signs[0] != signs[3] || signs[1] != signs[2])
+	{
+		// find the corner furthest through the plane
+		float centreOffset = glm::dot(aabb->getPosition(), collisionNormal) - plane->getDistance();
+		float side = centreOffset >= 0 ? 1.0f : -1.0f;
+		int deepest = 0;
+		for (int i = 1; i < 4; i++)
+		{
+			if (cornerOffsets[i] * side < cornerOffsets[deepest] * side)
+			{
+				deepest = i;
+			}
+		}
+
+		contact.bodyA = aabb->getStoreIndex();
+		contact.bodyB = plane->getStoreIndex();
+		contact.normal = -collisionNormal * side;
+		contact.points[0] = aabb->getCorner(deepest + 1);
+		contact.pointCount = 1;
+		contact.penetration = std::fabs(cornerOffsets[deepest]);
+		contact.featureId = 1 << deepest;
+		return true;
+	}
+	return false;
+}
+
+// test collision between an axis aligned bounding box and a sphere
+bool PhysicsScene::AABB2Sphere(Aabb* aabb, Sphere* sphere, Contact& contact)
+{
+	glm::vec2 boxToSphere;
+	boxToSphere.x = sphere->getPosition().x - fmaxf(aabb->getPosition().x - aabb->getWidth() / 2, fminf(sphere->getPosition().x, aabb->getPosition().x + aabb->getWidth() / 2));
+	boxToSphere.y = sphere->getPosition().y - fmaxf(aabb->getPosition().y - aabb->getHeight() / 2, fminf(sphere->getPosition().y, aabb->getPosition().y + aabb->getHeight() / 2));
+
+	float distance = glm::length(boxToSphere);
+	if (distance < sphere->getRadius())
+	{
+		// collision, a sphere centre inside the box gets pushed away from
+		// the box centre
+		contact.bodyA = aabb->getStoreIndex();
+		contact.bodyB = sphere->getStoreIndex();
+		contact.normal = distance > 0 ? boxToSphere / distance :
+			glm::normalize(sphere->getPosition() - aabb->getPosition());
+		contact.points[0] = sphere->getPosition() - boxToSphere;
+		contact.pointCount = 1;
+		contact.penetration = sphere->getRadius() - distance;
+		contact.featureId = 0;
+		return true;
+	}
+	return false;
+}
+
+// test collision between 2 axis aligned bounding boxes
+bool PhysicsScene::AABB2AABB(Aabb* Aabb1, Aabb* Aabb2, Contact& contact)
+{
+	glm::vec2 aMin = Aabb1->getMin();
+	glm::vec2 aMax = Aabb1->getMax();
+
+	glm::vec2 bMin = Aabb2->getMin();
+	glm::vec2 bMax = Aabb2->getMax();
+
+	if (aMax.x < bMin.x || aMin.x > bMax.x) return false;
+	if (aMax.y < bMin.y || aMin.y > bMax.y) return false;
+
+	float deltaX = (Aabb1->getExtents().x + Aabb2->getExtents().x) - fabsf(Aabb1->getPosition().x - Aabb2->getPosition().x);
+	float deltaY = (Aabb1->getExtents().y + Aabb2->getExtents().y) - fabsf(Aabb1->getPosition().y - Aabb2->getPosition().y);
+
+	contact.bodyA = Aabb1->getStoreIndex();
+	contact.bodyB = Aabb2->getStoreIndex();
+
+	// separate along the axis with the least overlap
+	if (deltaX < deltaY)
+	{
+		contact.normal = glm::vec2(Aabb2->getPosition().x >= Aabb1->getPosition().x ? 1.0f : -1.0f, 0);
+		contact.penetration = deltaX;
+		contact.featureId = 0;
+	}
+	else
+	{
+		contact.normal = glm::vec2(0, Aabb2->getPosition().y >= Aabb1->getPosition().y ? 1.0f : -1.0f);
+		contact.penetration = deltaY;
+		contact.featureId = 1;
+	}
+
+	// the middle of the overlapping region
+	contact.points[0] = 0.5f * (glm::max(aMin, bMin) + glm::min(aMax, bMax));
+	contact.pointCount = 1;
+
+	return true;
+}
@@ -0,0 +1,383 @@
+#pragma once
+#include <glm/vec2.hpp>
+#include <vector>
+#include <chrono>
+#include "PhysicsObject.h"
+#include "Broadphase.h"
+#include "BodyStore.h"
+#include "Contact.h"
+#include "ThreadPool.h"
+#include "ContactSolver.h"
+#include "UnionFind.h"
+#include "FrameGovernor.h"
+#include "AllocationCounter.h"
+#include "ObjectPool.h"
+
+class Plane;
+class Sphere;
+class Aabb;
+class Box;
+
+struct RenderState;
+
+class PhysicsScene
+{
+public:
+	PhysicsScene();
+	~PhysicsScene();
+
+	// the scene owns the actors it has been given. once it holds
+	// getMaxActors() actors any more are destroyed and a null handle is
+	// returned
+	ActorHandle addActor(PhysicsObject* actor);
+
+	// adds a batch of actors, reserving room for all of them first. returns
+	// how many fit, and fills in their handles if handles isn't nullptr
+	int addActors(PhysicsObject* const* actors, const int count, ActorHandle* handles = nullptr);
+	int addActors(const std::vector<PhysicsObject*>& actors) { return addActors(actors.data(), (int)actors.size()); }
+
+	// the actor a handle refers to, or nullptr once it has been removed
+	PhysicsObject* getActor(const ActorHandle handle) const;
+	bool isValid(const ActorHandle handle) const { return getActor(handle) != nullptr; }
+
+	// takes an actor out of the scene in constant time, log time with a
+	// DynamicTree broadphase as the tree rebalances. the last actor is
+	// moved into its place, so the order of m_actors changes. waking what
+	// it was touching and fixing up the contacts and the solver's cache are
+	// left for one pass over everything removed before the next step.
+	// the caller owns an actor it made with new again, but one from create
+	// still belongs to the scene's pool: it can be added back to this scene
+	// or given to destroyActor, and is destructed along with the scene
+	void removeActor(PhysicsObject* actor);
+	void removeActor(const ActorHandle handle);
+
+	// removes the actor if it's in the scene and frees it, back into its
+	// pool if it came from one
+	void destroyActor(PhysicsObject* actor);
+	void destroyActor(const ActorHandle handle);
+
+	// destroys the actor before the next fixed step, so it's safe to call
+	// while going over contacts or from other actors' callbacks. handles
+	// that are stale by then are ignored
+	void queueDestroy(const ActorHandle handle) { m_destroyQueue.push_back(handle); }
+	void flushDestroyQueue();
+
+	// makes an actor in the scene's pool for its shape. it still has to be
+	// set up and given to addActor, and only ever belongs to this scene
+	template <typename T>
+	T* create()
+	{
+		T* actor = getPool<T>().create();
+		actor->m_pooled = true;
+		return actor;
+	}
+
+	// the pool for a shape, reserve on it to make the slabs up front
+	template <typename T>
+	ObjectPool<T>& getPool();
+
+	void setMaxActors(const int maxActors) { m_maxActors = maxActors; }
+	int getMaxActors() const { return m_maxActors; }
+	int getActorCount() const { return (int)m_actors.size(); }
+	const std::vector<PhysicsObject*>& getActors() const { return m_actors; }
+
+	static constexpr int DEFAULT_MAX_ACTORS = 65536;
+
+	// adds dt to the scene's clock and takes as many fixed steps as fit,
+	// up to the max substeps. whole steps past that are dropped so a slow
+	// frame can't make the next one slower still
+	void update(const float dt);
+
+	// runs a single fixed step of getTimeStep(), whatever time has built up
+	void step();
+
+	void setMaxSubsteps(const int maxSubsteps) { m_maxSubsteps = maxSubsteps; }
+	int getMaxSubsteps() const { return m_maxSubsteps; }
+
+	static constexpr int DEFAULT_MAX_SUBSTEPS = 8;
+
+	// how far the time left over after the last update is into the next
+	// step, from 0 to 1. drawing bodies at their interpolated transforms
+	// with this hides the fixed rate
+	float getInterpolationAlpha() const { return m_accumulatedTime / m_timeStep; }
+
+	// how many whole steps updates have dropped for going over the max
+	// substeps
+	int getDroppedStepCount() const { return m_droppedStepCount; }
+
+	// how long a step can take, in milliseconds, before the governor
+	// starts trading quality for time. 0 turns it off
+	void setStepBudget(const double milliseconds);
+	const FrameGovernor& getGovernor() const { return m_governor; }
+
+	// copies what's needed to draw the scene and show its stats. the
+	// state's buffers are reused, so once they're big enough this doesn't
+	// allocate
+	void writeRenderState(RenderState& state) const;
+
+	// resting bodies outside this circle fall asleep sooner while the
+	// governor is lowering the quality. a radius of 0 means everywhere
+	void setFocus(const glm::vec2 center, const float radius) { m_focusCenter = center; m_focusRadius = radius; }
+
+	void setGravity(const glm::vec2 gravity) { m_gravity = gravity; }
+	void setGravity(const float x, const float y) { m_gravity = glm::vec2(x, y); }
+	glm::vec2 getGravity() const { return m_gravity; }
+
+	// the time step the scene was given. the governor can lengthen the
+	// one getTimeStep returns while the physics is over budget
+	void setTimeStep(const float timeStep);
+	float getTimeStep() const { return m_timeStep; }
+	float getBaseTimeStep() const { return m_baseTimeStep; }
+
+	// the longest step the governor will take
+	static constexpr float MAX_GOVERNED_TIME_STEP = 1.0f / 30.0f;
+
+	// the scene takes ownership of the broadphase, nullptr tests every pair
+	void setBroadphase(Broadphase* broadphase);
+	Broadphase* getBroadphase() const { return m_broadphase; }
+
+	BodyStore& getBodies() { return m_bodies; }
+
+	// how many threads the narrowphase uses, including the one calling
+	// update. 1 runs everything on the calling thread, which is what a
+	// scene starts with so several scenes don't each spawn a pool
+	void setThreadCount(const int threadCount);
+	int getThreadCount() const { return m_threadPool != nullptr ? m_threadPool->getThreadCount() : 1; }
+
+	// how many times the contact solver goes over the contacts each step
+	void setSolverIterations(const int iterations);
+	int getSolverIterations() const { return m_solver.getIterations(); }
+	ContactSolver& getSolver() { return m_solver; }
+
+	// bodies that stay slow for long enough are put to sleep along with
+	// everything they're touching. turning sleeping off wakes everything
+	void setSleepingEnabled(const bool enabled);
+	bool getSleepingEnabled() const { return m_sleepingEnabled; }
+
+	// how long a body has to be slower than the tolerances before it can
+	// sleep
+	static constexpr float TIME_TO_SLEEP = 0.5f;
+	static constexpr float SLEEP_LINEAR_TOLERANCE = 2.0f;
+	static constexpr float SLEEP_ANGULAR_TOLERANCE = 0.1f;
+
+	// finds the touching pairs and fills the contact buffer
+	void checkForCollison();
+
+	// runs the collision functions for m_pairs[begin, end)
+	void narrowphase(const int begin, const int end, std::vector<Contact>& contacts);
+
+	// responds to everything in the contact buffer with the contact solver
+	void resolveContacts();
+
+	const std::vector<Contact>& getContacts() const { return m_contacts; }
+
+	// the pairs the broadphase found in the last step
+	int getPairCount() const { return (int)m_pairs.size(); }
+
+	// how many heap allocations the last step made, always 0 in release
+	// builds. debug builds assert that a settled scene doesn't allocate
+	size_t getStepAllocations() const { return m_stepAllocations; }
+
+	// how many steps without new buffer growth before the scene is
+	// expected not to allocate
+	static constexpr int SETTLE_STEPS = 60;
+
+	// what the last step allocated by tag, kept while allocation tracking
+	// is turned on. the log gets a csv row per tag for every step
+	const AllocationCounter::Snapshot& getStepSnapshot() const { return m_stepSnapshot; }
+	void setAllocationLog(FILE* file) { m_allocationLog = file; }
+
+	// how many fixed steps the scene has taken
+	int getStepCount() const { return m_stepCount; }
+
+	// how many fixed steps the last update took
+	int getUpdateStepCount() const { return m_updateStepCount; }
+
+	// how long each phase of the last step took, in milliseconds
+	struct StepTimings
+	{
+		// integrating the bodies and updating their bounds
+		double integrate;
+		// sorting the actors and the broadphase finding pairs
+		double pairs;
+		// the collision functions
+		double narrowphase;
+		// islands and the contact solver
+		double response;
+		// updating sleep timers and putting islands to sleep
+		double sleeping;
+
+		double getTotal() const { return integrate + pairs + narrowphase + response + sleeping; }
+	};
+	const StepTimings& getStepTimings() const { return m_stepTimings; }
+
+	// sorts the actors into the active and inactive (static or sleeping)
+	// sets
+	void partitionActors();
+
+	// groups the bodies touching in the contact buffer into islands
+	void buildIslands();
+
+	// puts the islands that have been at rest long enough to sleep and
+	// wakes the ones that something has bumped into
+	void updateSleeping();
+
+	// wakes the bodies resting against one that is being moved. kinematic
+	// bodies are left out of islands and never paired with sleeping ones,
+	// so nothing else would notice
+	void wakeTouching(const RigidBody* body);
+
+	// wakes what the kinematic bodies moved since the last step were
+	// touching, where they were and where they are now
+	void wakeMovedBodies();
+
+	// what's kept of a removed body to wake what it was resting against.
+	// the body itself may be gone by the time that happens
+	struct RemovedBody
+	{
+		glm::vec2 min;
+		glm::vec2 max;
+		glm::vec2 normal;
+		float distance;
+		bool plane;
+	};
+	std::vector<RemovedBody> m_removedBodies;
+
+	// catches the contacts and the solver's cache up with the bodies
+	// removed since the last step and wakes what they were touching
+	void fixUpRemovedBodies();
+
+	// scene queries, these return every actor whose bounds are hit and use
+	// the broadphase to speed things up when it is a DynamicTree
+	void queryPoint(const glm::vec2 point, std::vector<PhysicsObject*>& results);
+	void queryAabb(const glm::vec2 min, const glm::vec2 max, std::vector<PhysicsObject*>& results);
+	void raycast(const glm::vec2 origin, const glm::vec2 direction, const float maxDistance,
+		std::vector<PhysicsObject*>& results);
+
+	// collision detection funtions
+	// only one order of each pair is written, the dispatch table fills in
+	// the other order automatically. these only describe the collision in
+	// the contact, resolveContacts does the responding
+	static bool sphere2Plane(Sphere* sphere, Plane* plane, Contact& contact);
+	static bool sphere2Sphere(Sphere* sphere1, Sphere* sphere2, Contact& contact);
+	static bool box2Plane(Box* box, Plane* plane, Contact& contact);
+	static bool box2Sphere(Box* box, Sphere* sphere, Contact& contact);
+	static bool box2Box(Box* box1, Box* box2, Contact& contact);
+	static bool AABB2Plane(Aabb* aabb, Plane* plane, Contact& contact);
+	static bool AABB2Sphere(Aabb* aabb, Sphere* sphere, Contact& contact);
+	static bool AABB2AABB(Aabb* Aabb1, Aabb* Aabb2, Contact& contact);
+
+protected:
+
+	glm::vec2 m_gravity;
+	float m_timeStep;
+	std::vector<PhysicsObject*>m_actors;
+	int m_maxActors = DEFAULT_MAX_ACTORS;
+
+	// where create makes each shape
+	ObjectPool<Sphere> m_spherePool;
+	ObjectPool<Box> m_boxPool;
+	ObjectPool<Aabb> m_aabbPool;
+	ObjectPool<Plane> m_planePool;
+
+	// deletes an actor, or gives it back to the pool it came from
+	void freeActor(PhysicsObject* actor);
+
+	// what each handle index refers to. a live slot holds the actor's index
+	// in m_actors, a free one holds the next free slot
+	struct ActorSlot
+	{
+		uint32_t generation;
+		int index;
+	};
+	std::vector<ActorSlot> m_actorSlots;
+	int m_freeSlot = -1;
+
+	// whether the actor is in this scene under its current handle
+	bool ownsActor(const PhysicsObject* actor) const;
+
+	std::vector<ActorHandle> m_destroyQueue;
+
+	// the simulation state of every RigidBody in the scene
+	BodyStore m_bodies;
+
+	// static, kinematic and sleeping actors are only ever tested against
+	// active ones
+	std::vector<PhysicsObject*> m_dynamicActors;
+	std::vector<PhysicsObject*> m_staticActors;
+
+	Broadphase* m_broadphase = nullptr;
+	std::vector<CollisionPair> m_pairs;
+
+	// the contacts found this step
+	std::vector<Contact> m_contacts;
+	ContactSolver m_solver;
+
+	bool m_sleepingEnabled = true;
+	UnionFind m_islands;
+	std::vector<float> m_islandSleepTime;
+
+	// the narrowphase splits the pairs into chunks with their own contact
+	// buffers, which get appended in chunk order so the result is the same
+	// however the chunks were spread over the threads
+	static void narrowphaseChunk(void* scene, int chunk);
+
+	ThreadPool* m_threadPool = nullptr;
+	std::vector<std::vector<Contact>> m_chunkContacts;
+	int m_chunkCount = 0;
+
+	// below this many pairs the narrowphase isn't worth splitting up
+	static constexpr int MIN_PAIRS_PER_CHUNK = 64;
+
+	// records the allocations of a step and checks there weren't any once
+	// the scene has settled
+	void checkAllocations(const size_t allocations);
+
+	// allocations made on the thread stepping the scene and by its pool,
+	// other threads can be allocating while a step runs
+	size_t countAllocations() const;
+
+	size_t m_stepAllocations = 0;
+	size_t m_maxPairs = 0;
+	size_t m_maxContacts = 0;
+	size_t m_maxBatches = 0;
+	size_t m_broadphaseAllocations = 0;
+
+	AllocationCounter::Snapshot m_stepSnapshot = {};
+	FILE* m_allocationLog = nullptr;
+	int m_stepCount = 0;
+	int m_updateStepCount = 0;
+
+	float m_accumulatedTime = 0.0f;
+	float m_baseTimeStep;
+	int m_baseIterations = 0;
+
+	// sets the time step and solver iterations for the governor's level
+	void applyQuality();
+
+	FrameGovernor m_governor;
+	glm::vec2 m_focusCenter = glm::vec2(0);
+	float m_focusRadius = 0.0f;
+	int m_maxSubsteps = DEFAULT_MAX_SUBSTEPS;
+	int m_droppedStepCount = 0;
+
+	typedef std::chrono::high_resolution_clock Clock;
+	static double getMilliseconds(const Clock::time_point start, const Clock::time_point end)
+	{
+		return std::chrono::duration<double, std::milli>(end - start).count();
+	}
+	StepTimings m_stepTimings = {};
+	int m_settledSteps = 0;
+};
+
+template <>
+inline ObjectPool<Sphere>& PhysicsScene::getPool<Sphere>() { return m_spherePool; }
+
+template <>
+inline ObjectPool<Box>& PhysicsScene::getPool<Box>() { return m_boxPool; }
+
+template <>
+inline ObjectPool<Aabb>& PhysicsScene::getPool<Aabb>() { return m_aabbPool; }
+
+template <>
+inline ObjectPool<Plane>& PhysicsScene::getPool<Plane>() { return m_planePool; }
\ No newline at end of file
@@ -0,0 +1,128 @@
+#include "PhysicsThread.h"
+#include "PhysicsScene.h"
+#include "Profiler.h"
+#include <future>
+
+PhysicsThread::PhysicsThread(PhysicsScene* scene) : m_scene(scene)
+{
+}
+
+PhysicsThread::~PhysicsThread()
+{
+	stop();
+}
+
+void PhysicsThread::start()
+{
+	if (isRunning())
+	{
+		return;
+	}
+
+	// publish the scene as it is so there's something to draw before the
+	// first update
+	runCommands();
+	Published& published = m_states.getBack();
+	m_scene->writeRenderState(published.state);
+	published.time = Clock::now();
+	m_states.publish();
+
+	m_quit = false;
+	m_thread = std::thread(&PhysicsThread::run, this);
+}
+
+void PhysicsThread::stop()
+{
+	if (!isRunning())
+	{
+		return;
+	}
+
+	m_quit = true;
+	m_thread.join();
+
+	// anything posted too late still gets done
+	runCommands();
+}
+
+void PhysicsThread::post(std::function<void(PhysicsScene&)> command)
+{
+	std::lock_guard<std::mutex> lock(m_commandMutex);
+	m_commands.push_back(std::move(command));
+}
+
+void PhysicsThread::postAndWait(std::function<void(PhysicsScene&)> command)
+{
+	if (!isRunning())
+	{
+		runCommands();
+		command(*m_scene);
+		return;
+	}
+
+	std::promise<void> done;
+	std::future<void> ran = done.get_future();
+	post([&command, &done](PhysicsScene& scene)
+	{
+		command(scene);
+		done.set_value();
+	});
+	ran.wait();
+}
+
+const RenderState& PhysicsThread::acquire()
+{
+	m_states.acquire();
+	return m_states.getFront().state;
+}
+
+float PhysicsThread::getInterpolationAlpha() const
+{
+	const Published& published = m_states.getFront();
+	float elapsed = std::chrono::duration<float>(Clock::now() - published.time).count();
+
+	// the state is from the last update, by now the scene is further on
+	float alpha = published.state.interpolationAlpha + elapsed / published.state.stats.timeStep;
+	return alpha < 1.0f ? alpha : 1.0f;
+}
+
+void PhysicsThread::run()
+{
+	Clock::time_point last = Clock::now();
+
+	while (!m_quit)
+	{
+		runCommands();
+
+		Clock::time_point now = Clock::now();
+		m_scene->update(std::chrono::duration<float>(now - last).count());
+		last = now;
+
+		{
+			PROFILE_ZONE("PhysicsThread::publish");
+			Published& published = m_states.getBack();
+			m_scene->writeRenderState(published.state);
+			published.time = now;
+			m_states.publish();
+			m_publishCount.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		// sleep until the next step is due
+		float wait = (1.0f - m_scene->getInterpolationAlpha()) * m_scene->getTimeStep();
+		std::this_thread::sleep_for(std::chrono::duration<float>(wait));
+	}
+}
+
+void PhysicsThread::runCommands()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_commandMutex);
+		m_runningCommands.swap(m_commands);
+	}
+
+	for (auto& command : m_runningCommands)
+	{
+		command(*m_scene);
+	}
+	m_runningCommands.clear();
+}
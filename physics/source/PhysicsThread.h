@@ -0,0 +1,77 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "RenderState.h"
+#include "TripleBuffer.h"
+
+class PhysicsScene;
+
+// steps a scene on a thread of its own at the scene's fixed rate. after
+// every update it writes a RenderState into a triple buffer, so drawing
+// reads the newest state without waiting on the physics and a slow frame
+// doesn't hold the simulation up. while the thread is running nothing
+// else may touch the scene, changes go through post
+class PhysicsThread
+{
+public:
+	// the scene stays owned by the caller and has to outlive the thread
+	PhysicsThread(PhysicsScene* scene);
+	~PhysicsThread();
+
+	PhysicsThread(const PhysicsThread&) = delete;
+	PhysicsThread& operator=(const PhysicsThread&) = delete;
+
+	void start();
+
+	// waits for the update in progress to finish, after which the scene
+	// can be used directly again
+	void stop();
+	bool isRunning() const { return m_thread.joinable(); }
+
+	// runs the command on the physics thread before its next update
+	void post(std::function<void(PhysicsScene&)> command);
+
+	// the same, but waits for the command to have run. nothing else is
+	// happening on the physics thread while it runs, and the caller is
+	// stuck here, so neither of them is in the middle of anything
+	void postAndWait(std::function<void(PhysicsScene&)> command);
+
+	// swaps in the newest state the physics thread has published. the
+	// state stays the same until the next acquire
+	const RenderState& acquire();
+
+	// how far to blend the acquired state's bodies from their previous
+	// transforms, going by the time since it was published
+	float getInterpolationAlpha() const;
+
+	// how many updates the physics thread has published
+	int getPublishCount() const { return m_publishCount.load(std::memory_order_relaxed); }
+
+private:
+	typedef std::chrono::steady_clock Clock;
+
+	void run();
+	void runCommands();
+
+	struct Published
+	{
+		RenderState state;
+		Clock::time_point time;
+	};
+
+	PhysicsScene* m_scene;
+	std::thread m_thread;
+	std::atomic<bool> m_quit{ false };
+	std::atomic<int> m_publishCount{ 0 };
+
+	TripleBuffer<Published> m_states;
+
+	// commands are swapped out under the lock and run without it
+	std::mutex m_commandMutex;
+	std::vector<std::function<void(PhysicsScene&)>> m_commands;
+	std::vector<std::function<void(PhysicsScene&)>> m_runningCommands;
+};
@@ -0,0 +1,31 @@
+#include "Plane.h"
+#include <glm/ext.hpp>
+#include <cfloat>
+#include <cmath>
+
+Plane::Plane() :
+	RigidBody(ShapeTypes::PLANE)
+{
+	// planes are always kinematic
+	setKinematic(true);
+
+	// and their bounds never change
+	calculateBounds();
+}
+
+// planes are infinite so their bounds cover everything
+void Plane::calculateBounds()
+{
+	m_boundsMin = glm::vec2(-FLT_MAX);
+	m_boundsMax = glm::vec2(FLT_MAX);
+}
+
+bool Plane::overlaps(const glm::vec2 normal, const float distance, const glm::vec2 min, const glm::vec2 max)
+{
+	glm::vec2 centre = (min + max) * 0.5f;
+	glm::vec2 extents = (max - min) * 0.5f;
+
+	float offset = glm::dot(centre, normal) - distance;
+	float radius = extents.x * std::abs(normal.x) + extents.y * std::abs(normal.y);
+	return std::abs(offset) <= radius;
+}
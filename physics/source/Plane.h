@@ -1,5 +1,5 @@
 #pragma once
-#include <glm\glm.hpp>
+#include <glm/glm.hpp>
 #include "RigidBody.h"
 
 class Plane : public RigidBody
@@ -8,7 +8,7 @@ public:
 	Plane();
 	~Plane() {};
 
-	virtual void draw();
+	virtual void calculateBounds();
 
 	glm::vec2 getPosition() const { return m_distance * m_normal; }
 	glm::vec2 getNormal() const { return m_normal; }
@@ -18,7 +18,10 @@ public:
 	void setNormal(const float x, const float y) { m_normal = glm::normalize(glm::vec2(x, y)); }
 	void setDistance(const float distance) { m_distance = distance; }
 
-	void resolveCollision(RigidBody* actor2, const glm::vec2 contact);
+	// planes are two sided, so a box touches one unless it's wholly on
+	// one side of it
+	bool overlaps(const glm::vec2 min, const glm::vec2 max) const { return overlaps(m_normal, m_distance, min, max); }
+	static bool overlaps(const glm::vec2 normal, const float distance, const glm::vec2 min, const glm::vec2 max);
 
 protected:
 	glm::vec2 m_normal = glm::vec2(0, 1);
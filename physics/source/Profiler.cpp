@@ -0,0 +1,194 @@
+#include "Profiler.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+	struct Event
+	{
+		const char* name;
+		uint64_t start;
+		uint64_t end;
+	};
+
+	// a thread's zones. only its own thread writes to it, the count is
+	// atomic so writing the trace from another thread sees whole events.
+	// clearing moves the start up to the count rather than resetting it,
+	// so it doesn't race with the thread recording
+	struct ThreadBuffer
+	{
+		int threadId;
+		std::vector<Event> events;
+		std::atomic<uint64_t> count;
+		std::atomic<uint64_t> start;
+	};
+
+	// counter values at the end of a frame
+	struct CounterSample
+	{
+		uint64_t time;
+		int64_t values[Profiler::COUNTER_COUNT];
+	};
+
+	std::atomic<bool> s_enabled(false);
+	const std::chrono::steady_clock::time_point s_startTime = std::chrono::steady_clock::now();
+
+	// buffers are never freed, a thread pool's workers can be gone by the
+	// time the trace is written
+	std::mutex s_mutex;
+	std::vector<ThreadBuffer*> s_buffers;
+	std::vector<CounterSample> s_samples;
+	thread_local ThreadBuffer* s_buffer = nullptr;
+
+	std::atomic<int64_t> s_counters[Profiler::COUNTER_COUNT];
+	int64_t s_frameCounters[Profiler::COUNTER_COUNT] = {};
+
+	// the most samples kept before the oldest are dropped
+	constexpr size_t MAX_SAMPLES = 1 << 14;
+
+	ThreadBuffer* getBuffer()
+	{
+		if (s_buffer == nullptr)
+		{
+			std::lock_guard<std::mutex> lock(s_mutex);
+			s_buffer = new ThreadBuffer();
+			s_buffer->threadId = (int)s_buffers.size();
+			s_buffer->events.resize(Profiler::EVENTS_PER_THREAD);
+			s_buffer->count = 0;
+			s_buffer->start = 0;
+			s_buffers.push_back(s_buffer);
+		}
+		return s_buffer;
+	}
+}
+
+void Profiler::setEnabled(const bool enabled)
+{
+	// with the zones compiled out there's nothing to capture
+#if defined(PROFILER_ENABLED)
+	s_enabled.store(enabled, std::memory_order_relaxed);
+#else
+	(void)enabled;
+#endif
+}
+
+bool Profiler::isEnabled()
+{
+	return s_enabled.load(std::memory_order_relaxed);
+}
+
+uint64_t Profiler::getTime()
+{
+	return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now() - s_startTime).count();
+}
+
+void Profiler::recordZone(const char* name, const uint64_t start, const uint64_t end)
+{
+	ThreadBuffer* buffer = getBuffer();
+	uint64_t count = buffer->count.load(std::memory_order_relaxed);
+	buffer->events[count % EVENTS_PER_THREAD] = { name, start, end };
+	buffer->count.store(count + 1, std::memory_order_release);
+}
+
+void Profiler::addCount(const Counter counter, const int64_t value)
+{
+	s_counters[counter].fetch_add(value, std::memory_order_relaxed);
+}
+
+const char* Profiler::getCounterName(const Counter counter)
+{
+	static const char* names[COUNTER_COUNT] = { "pairs_tested", "contacts_found", "draw_calls", "vertices_flushed" };
+	return names[counter];
+}
+
+void Profiler::endFrame()
+{
+	CounterSample sample;
+	sample.time = getTime();
+	for (int i = 0; i < COUNTER_COUNT; i++)
+	{
+		sample.values[i] = s_counters[i].exchange(0, std::memory_order_relaxed);
+		s_frameCounters[i] = sample.values[i];
+	}
+
+	if (isEnabled())
+	{
+		std::lock_guard<std::mutex> lock(s_mutex);
+		if (s_samples.size() >= MAX_SAMPLES)
+		{
+			s_samples.erase(s_samples.begin(), s_samples.begin() + MAX_SAMPLES / 2);
+		}
+		s_samples.push_back(sample);
+	}
+}
+
+const int64_t* Profiler::getFrameCounters()
+{
+	return s_frameCounters;
+}
+
+bool Profiler::writeChromeTrace(FILE* file)
+{
+	std::lock_guard<std::mutex> lock(s_mutex);
+
+	// timestamps are in microseconds
+	fprintf(file, "{\"traceEvents\":[\n");
+	bool first = true;
+
+	for (auto buffer : s_buffers)
+	{
+		uint64_t count = buffer->count.load(std::memory_order_acquire);
+		uint64_t begin = count > (uint64_t)EVENTS_PER_THREAD ? count - EVENTS_PER_THREAD : 0;
+		begin = std::max(begin, buffer->start.load(std::memory_order_relaxed));
+
+		fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s %d\"}}",
+			first ? "" : ",\n", buffer->threadId, buffer->threadId == 0 ? "main" : "thread", buffer->threadId);
+		first = false;
+
+		for (uint64_t i = begin; i < count; i++)
+		{
+			const Event& event = buffer->events[i % EVENTS_PER_THREAD];
+			fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+				event.name, buffer->threadId, event.start / 1000.0, (event.end - event.start) / 1000.0);
+		}
+	}
+
+	for (auto& sample : s_samples)
+	{
+		for (int i = 0; i < COUNTER_COUNT; i++)
+		{
+			fprintf(file, "%s{\"name\":\"%s\",\"ph\":\"C\",\"pid\":1,\"ts\":%.3f,\"args\":{\"value\":%lld}}",
+				first ? "" : ",\n", getCounterName((Counter)i), sample.time / 1000.0, (long long)sample.values[i]);
+			first = false;
+		}
+	}
+
+	fprintf(file, "\n]}\n");
+	return ferror(file) == 0;
+}
+
+bool Profiler::writeChromeTrace(const char* path)
+{
+	FILE* file = fopen(path, "w");
+	if (file == nullptr)
+	{
+		return false;
+	}
+	bool written = writeChromeTrace(file);
+	fclose(file);
+	return written;
+}
+
+void Profiler::clear()
+{
+	std::lock_guard<std::mutex> lock(s_mutex);
+	for (auto buffer : s_buffers)
+	{
+		buffer->start.store(buffer->count.load(std::memory_order_acquire), std::memory_order_relaxed);
+	}
+	s_samples.clear();
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+
+// a scoped zone profiler. PROFILE_ZONE times the rest of the block it's in
+// and PROFILE_COUNT adds to one of the counters. every thread records its
+// zones into its own ring buffer, so nothing is shared on the hot path and
+// old zones are overwritten once a buffer is full. define
+// PROFILER_DISABLED to compile every zone and counter out, otherwise they
+// cost a load and a branch until profiling is turned on
+#if !defined(PROFILER_DISABLED)
+#define PROFILER_ENABLED 1
+#endif
+
+namespace Profiler
+{
+	// the things worth counting along with the zones
+	enum Counter
+	{
+		PAIRS_TESTED = 0,
+		CONTACTS_FOUND,
+		DRAW_CALLS,
+		VERTICES_FLUSHED,
+		COUNTER_COUNT
+	};
+
+	// zones and counters are only recorded while this is on
+	void setEnabled(const bool enabled);
+	bool isEnabled();
+
+	// how many zones each thread keeps before overwriting the oldest
+	static constexpr int EVENTS_PER_THREAD = 1 << 16;
+
+	// nanoseconds since the profiler started
+	uint64_t getTime();
+
+	// zones are recorded when they end, the name has to outlive the
+	// profiler so it should be a string literal
+	void recordZone(const char* name, const uint64_t start, const uint64_t end);
+
+	void addCount(const Counter counter, const int64_t value);
+	const char* getCounterName(const Counter counter);
+
+	// closes off a frame, which adds the counters to the trace and starts
+	// them again from 0. getFrameCounters gives the last frame's values
+	void endFrame();
+	const int64_t* getFrameCounters();
+
+	// writes everything still in the ring buffers as chrome trace_event
+	// json, open it in chrome://tracing or perfetto. call it when no other
+	// thread is recording
+	bool writeChromeTrace(FILE* file);
+	bool writeChromeTrace(const char* path);
+
+	// throws away everything recorded so far
+	void clear();
+
+	class ScopedZone
+	{
+	public:
+		ScopedZone(const char* name) : m_name(isEnabled() ? name : nullptr), m_start(m_name != nullptr ? getTime() : 0) {}
+		~ScopedZone()
+		{
+			if (m_name != nullptr)
+			{
+				recordZone(m_name, m_start, getTime());
+			}
+		}
+
+		ScopedZone(const ScopedZone&) = delete;
+		ScopedZone& operator=(const ScopedZone&) = delete;
+
+	private:
+		const char* m_name;
+		uint64_t m_start;
+	};
+}
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#if defined(PROFILER_ENABLED)
+#define PROFILE_ZONE(name) Profiler::ScopedZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define PROFILE_COUNT(counter, value) do { if (Profiler::isEnabled()) Profiler::addCount(Profiler::counter, value); } while (0)
+#else
+#define PROFILE_ZONE(name) do {} while (0)
+#define PROFILE_COUNT(counter, value) do {} while (0)
+#endif
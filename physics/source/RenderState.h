@@ -0,0 +1,54 @@
+#pragma once
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+#include <vector>
+#include "PhysicsScene.h"
+
+// a copy of everything needed to draw a scene and show its stats, so the
+// scene can keep stepping on another thread while the copy is drawn
+struct RenderState
+{
+	// a body's transform before and after the last step, drawing blends
+	// between them
+	struct Body
+	{
+		ShapeTypes shape;
+		glm::vec2 previousPosition;
+		glm::vec2 position;
+		float previousRotation;
+		float rotation;
+		// the radius for spheres, the extents for boxes and aabbs
+		glm::vec2 size;
+		glm::vec4 color;
+	};
+
+	struct Plane
+	{
+		glm::vec2 normal;
+		float distance;
+	};
+
+	struct Stats
+	{
+		int actorCount;
+		int pairCount;
+		int contactCount;
+		int updateStepCount;
+		int maxSubsteps;
+		int droppedStepCount;
+		int solverIterations;
+		float timeStep;
+		PhysicsScene::StepTimings stepTimings;
+		FrameGovernor::Stats governor;
+		bool reducedDetail;
+		AllocationCounter::Snapshot stepAllocations;
+	};
+
+	std::vector<Body> bodies;
+	std::vector<Plane> planes;
+	Stats stats;
+
+	// how far the scene was into its next step when this was written
+	float interpolationAlpha;
+	int stepCount;
+};
@@ -0,0 +1,131 @@
+#include "RigidBody.h"
+#include <glm/ext.hpp>
+
+RigidBody::RigidBody(ShapeTypes shapeID) :
+	PhysicsObject(shapeID)
+{
+	// bodies keep their own state until they are added to a scene
+	m_detached.shape = (uint8_t)shapeID;
+
+	updateInvMass();
+	setMoment(m_moment);
+	setFriction(0.3f);
+}
+
+RigidBody::~RigidBody()
+{
+	setStore(nullptr);
+}
+
+void RigidBody::setStore(BodyStore* store)
+{
+	if (store == m_store)
+	{
+		return;
+	}
+
+	BodyStore::Body body = m_detached;
+	if (m_store != nullptr)
+	{
+		m_store->read(m_index, body);
+		m_store->remove(m_index);
+	}
+
+	m_store = store;
+	if (store != nullptr)
+	{
+		m_index = store->add(this, body);
+	}
+	else
+	{
+		m_detached = body;
+		m_index = -1;
+	}
+}
+
+glm::vec2 RigidBody::getInterpolatedPosition(const float alpha) const
+{
+	glm::vec2 previous(storedPreviousX(), storedPreviousY());
+	return previous + (getPosition() - previous) * alpha;
+}
+
+float RigidBody::getInterpolatedRotation(const float alpha) const
+{
+	float previous = storedPreviousRotation();
+	return previous + (getRotation() - previous) * alpha;
+}
+
+// setting the position or rotation moves the body there outright, so
+// drawing doesn't blend in from where it was
+void RigidBody::setPosition(const float x, const float y)
+{
+	storedPositionX() = x;
+	storedPositionY() = y;
+	storedPreviousX() = x;
+	storedPreviousY() = y;
+	markMoved();
+}
+
+void RigidBody::setRotation(const float rotation)
+{
+	storedRotation() = rotation;
+	storedPreviousRotation() = rotation;
+	storedRotationCos() = cosf(rotation);
+	storedRotationSin() = sinf(rotation);
+	markMoved();
+}
+
+// nothing is paired with a sleeping body and a kinematic one, so a scene
+// has to be told when a kinematic body jumps out from under something
+void RigidBody::markMoved()
+{
+	if (isKinematic() && m_store != nullptr && m_movedIndex < 0)
+	{
+		m_movedIndex = (int)m_store->m_moved.size();
+		m_store->m_moved.push_back(this);
+	}
+}
+
+void RigidBody::setSleeping(const bool sleeping)
+{
+	storedAsleep() = sleeping;
+	storedSleepTime() = 0;
+
+	if (sleeping)
+	{
+		storedVelocityX() = 0;
+		storedVelocityY() = 0;
+		storedAngularVelocity() = 0;
+	}
+}
+
+// updates the RigidBody using a fixed timestep
+// PhysicsScene integrates all of its bodies in one pass over its store,
+// this integrates just this one
+void RigidBody::fixedUpdate(const glm::vec2 gravity, const float timeStep)
+{
+	if (m_store != nullptr)
+	{
+		m_store->integrate(gravity, timeStep, m_index, m_index + 1);
+	}
+	else
+	{
+		BodyStore::integrate(m_detached, gravity, timeStep);
+	}
+
+	// the bounds are only worked out once per step
+	calculateBounds();
+}
+
+// apply force to the RigidBody at the specified position
+void RigidBody::applyForce(const glm::vec2 force, const glm::vec2 pos)
+{
+	// pushing a sleeping body wakes it up
+	wake();
+
+	// Force = mass * acceleration
+	// therefore acceleration = Force / mass
+	setVelocity(getVelocity() + force / m_mass);
+
+	setAngularVelocity(getAngularVelocity() + (force.y * pos.x - force.x * pos.y) * storedInvMoment());
+}
@@ -0,0 +1,129 @@
+#pragma once
+#include "PhysicsObject.h"
+#include "BodyStore.h"
+#include <climits>
+
+// a thin handle onto a body's simulation state, which lives in a BodyStore
+class RigidBody : public PhysicsObject
+{
+public:
+	RigidBody(ShapeTypes shapeID);
+	virtual ~RigidBody();
+
+	RigidBody(const RigidBody&) = delete;
+	RigidBody& operator=(const RigidBody&) = delete;
+
+	virtual void fixedUpdate(const glm::vec2 gravity, const float timeStep);
+	void applyForce(const glm::vec2 force, const glm::vec2 pos);
+
+	// moves this body's state into a store, or back into the body with
+	// nullptr. PhysicsScene does this when the body is added or removed
+	void setStore(BodyStore* store);
+	BodyStore* getStore() const { return m_store; }
+	int getStoreIndex() const { return m_index; }
+
+	bool isKinematic() const { return storedKinematic() != 0; }
+	virtual bool isStatic() const { return isKinematic(); }
+	virtual bool isSleeping() const { return storedAsleep() != 0; }
+	glm::vec2 getPosition() const { return glm::vec2(storedPositionX(), storedPositionY()); }
+	glm::vec2 getVelocity() const { return glm::vec2(storedVelocityX(), storedVelocityY()); }
+	float getRotation() const { return storedRotation(); }
+
+	// blends from where the body was before the last step (alpha 0) to
+	// where it is now (alpha 1)
+	glm::vec2 getInterpolatedPosition(const float alpha) const;
+	float getInterpolatedRotation(const float alpha) const;
+
+	float getRotationCos() const { return storedRotationCos(); }
+	float getRotationSin() const { return storedRotationSin(); }
+	float getAngularVelocity() const { return storedAngularVelocity(); }
+	float getMass() const { return isKinematic() ? INT_MAX : m_mass; }
+	float invMass() const { return storedInvMass(); }
+	float getElasticity() const { return m_elasticity; }
+	float getMoment() const { return m_moment; }
+	float invMoment() const { return storedInvMoment(); }
+	float getFriction() const { return storedFriction(); }
+	glm::vec4 getColor() const { return m_color; }
+
+	void setKinematic(const bool b) { storedKinematic() = b; updateInvMass(); }
+	void setPosition(const glm::vec2 position) { setPosition(position.x, position.y); }
+	void setPosition(const float x, const float y);
+	void setVelocity(const glm::vec2 velocity) { setVelocity(velocity.x, velocity.y); }
+	void setVelocity(const float x, const float y) { storedVelocityX() = x; storedVelocityY() = y; wake(); }
+	void setRotation(const float rotation);
+	void setAngularVelocity(const float angularVelocity) { storedAngularVelocity() = angularVelocity; wake(); }
+	void setMass(const float mass) { m_mass = mass; updateInvMass(); }
+	void setElasticity(const float elasticity) { m_elasticity = elasticity; }
+	void setMoment(const float moment) { m_moment = moment; updateInvMoment(); }
+	void setFriction(const float friction) { storedFriction() = friction; }
+	void setColor(const glm::vec4 color) { m_color = color; }
+
+	// a sleeping body has its velocity zeroed, waking it restarts its
+	// sleep timer
+	void setSleeping(const bool sleeping);
+	void wake() { if (storedAsleep()) setSleeping(false); }
+
+protected:
+
+	friend class BodyStore;
+
+	// lets the scene wake what a kinematic body was touching
+	void markMoved();
+
+	// the body's state is a row of its scene's store, or m_detached while
+	// it isn't in one
+	float& storedPositionX() { return m_store != nullptr ? m_store->m_positionX[m_index] : m_detached.positionX; }
+	float storedPositionX() const { return m_store != nullptr ? m_store->m_positionX[m_index] : m_detached.positionX; }
+	float& storedPositionY() { return m_store != nullptr ? m_store->m_positionY[m_index] : m_detached.positionY; }
+	float storedPositionY() const { return m_store != nullptr ? m_store->m_positionY[m_index] : m_detached.positionY; }
+	float& storedVelocityX() { return m_store != nullptr ? m_store->m_velocityX[m_index] : m_detached.velocityX; }
+	float storedVelocityX() const { return m_store != nullptr ? m_store->m_velocityX[m_index] : m_detached.velocityX; }
+	float& storedVelocityY() { return m_store != nullptr ? m_store->m_velocityY[m_index] : m_detached.velocityY; }
+	float storedVelocityY() const { return m_store != nullptr ? m_store->m_velocityY[m_index] : m_detached.velocityY; }
+	float& storedRotation() { return m_store != nullptr ? m_store->m_rotation[m_index] : m_detached.rotation; }
+	float storedRotation() const { return m_store != nullptr ? m_store->m_rotation[m_index] : m_detached.rotation; }
+	float& storedRotationCos() { return m_store != nullptr ? m_store->m_rotationCos[m_index] : m_detached.rotationCos; }
+	float storedRotationCos() const { return m_store != nullptr ? m_store->m_rotationCos[m_index] : m_detached.rotationCos; }
+	float& storedRotationSin() { return m_store != nullptr ? m_store->m_rotationSin[m_index] : m_detached.rotationSin; }
+	float storedRotationSin() const { return m_store != nullptr ? m_store->m_rotationSin[m_index] : m_detached.rotationSin; }
+	float& storedAngularVelocity() { return m_store != nullptr ? m_store->m_angularVelocity[m_index] : m_detached.angularVelocity; }
+	float storedAngularVelocity() const { return m_store != nullptr ? m_store->m_angularVelocity[m_index] : m_detached.angularVelocity; }
+	float& storedPreviousX() { return m_store != nullptr ? m_store->m_previousX[m_index] : m_detached.previousX; }
+	float storedPreviousX() const { return m_store != nullptr ? m_store->m_previousX[m_index] : m_detached.previousX; }
+	float& storedPreviousY() { return m_store != nullptr ? m_store->m_previousY[m_index] : m_detached.previousY; }
+	float storedPreviousY() const { return m_store != nullptr ? m_store->m_previousY[m_index] : m_detached.previousY; }
+	float& storedPreviousRotation() { return m_store != nullptr ? m_store->m_previousRotation[m_index] : m_detached.previousRotation; }
+	float storedPreviousRotation() const { return m_store != nullptr ? m_store->m_previousRotation[m_index] : m_detached.previousRotation; }
+	float& storedInvMass() { return m_store != nullptr ? m_store->m_invMass[m_index] : m_detached.invMass; }
+	float storedInvMass() const { return m_store != nullptr ? m_store->m_invMass[m_index] : m_detached.invMass; }
+	float& storedInvMoment() { return m_store != nullptr ? m_store->m_invMoment[m_index] : m_detached.invMoment; }
+	float storedInvMoment() const { return m_store != nullptr ? m_store->m_invMoment[m_index] : m_detached.invMoment; }
+	float& storedFriction() { return m_store != nullptr ? m_store->m_friction[m_index] : m_detached.friction; }
+	float storedFriction() const { return m_store != nullptr ? m_store->m_friction[m_index] : m_detached.friction; }
+	uint8_t& storedShape() { return m_store != nullptr ? m_store->m_shape[m_index] : m_detached.shape; }
+	uint8_t storedShape() const { return m_store != nullptr ? m_store->m_shape[m_index] : m_detached.shape; }
+	uint8_t& storedKinematic() { return m_store != nullptr ? m_store->m_kinematic[m_index] : m_detached.kinematic; }
+	uint8_t storedKinematic() const { return m_store != nullptr ? m_store->m_kinematic[m_index] : m_detached.kinematic; }
+	uint8_t& storedAsleep() { return m_store != nullptr ? m_store->m_asleep[m_index] : m_detached.asleep; }
+	uint8_t storedAsleep() const { return m_store != nullptr ? m_store->m_asleep[m_index] : m_detached.asleep; }
+	float& storedSleepTime() { return m_store != nullptr ? m_store->m_sleepTime[m_index] : m_detached.sleepTime; }
+	float storedSleepTime() const { return m_store != nullptr ? m_store->m_sleepTime[m_index] : m_detached.sleepTime; }
+
+	void updateInvMass() { storedInvMass() = isKinematic() ? 1.0f / INT_MAX : 1.0f / m_mass; }
+
+	// bodies that never had their moment worked out don't rotate
+	void updateInvMoment() { storedInvMoment() = m_moment > 0 ? 1.0f / m_moment : 0.0f; }
+
+	// where the hot simulation state lives
+	BodyStore* m_store = nullptr;
+	int m_index = -1;
+	int m_movedIndex = -1;
+	BodyStore::Body m_detached;
+
+	// the rest is only needed when setting up bodies and resolving collisions
+	float m_mass = 1;
+	float m_elasticity = 1;
+	float m_moment = 0;
+
+	glm::vec4 m_color = glm::vec4(1);
+};
@@ -0,0 +1,140 @@
+#pragma once
+
+// picks the widest instruction set the compiler has been told it can use
+// build with /arch:AVX2 (or -mavx2) to get the 8 wide paths, SSE2 is always
+// there on x64 so that is the baseline. anything else falls back to scalar
+#if defined(__AVX2__)
+#define PHYSICS_SIMD_AVX2 1
+#define PHYSICS_SIMD_SSE2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PHYSICS_SIMD_SSE2 1
+#endif
+
+#if defined(PHYSICS_SIMD_AVX2)
+#include <immintrin.h>
+#elif defined(PHYSICS_SIMD_SSE2)
+#include <emmintrin.h>
+#endif
+
+namespace SimdMath
+{
+	// the range reduction below loses precision past this, callers fall
+	// back to the scalar sin and cos for lanes bigger than it
+	static constexpr float SINCOS_MAX_INPUT = 8192.0f;
+
+	// the constants for the cephes sinf / cosf polynomials
+	static constexpr float FOUR_OVER_PI = 1.27323954473516f;
+	static constexpr float DP1 = -0.78515625f;
+	static constexpr float DP2 = -2.4187564849853515625e-4f;
+	static constexpr float DP3 = -3.77489497744594108e-8f;
+	static constexpr float SIN_P0 = -1.9515295891e-4f;
+	static constexpr float SIN_P1 = 8.3321608736e-3f;
+	static constexpr float SIN_P2 = -1.6666654611e-1f;
+	static constexpr float COS_P0 = 2.443315711809948e-5f;
+	static constexpr float COS_P1 = -1.388731625493765e-3f;
+	static constexpr float COS_P2 = 4.166664568298827e-2f;
+
+#if defined(PHYSICS_SIMD_SSE2)
+	// works out the sine and cosine of 4 angles at once
+	inline void sincos4(__m128 x, __m128& s, __m128& c)
+	{
+		const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32(0x80000000));
+
+		// work with the absolute value and put the sign back on the sine
+		__m128 signSin = _mm_and_ps(x, signMask);
+		x = _mm_andnot_ps(signMask, x);
+
+		// find which octant the angle is in, rounded up to an even one
+		__m128i octant = _mm_cvttps_epi32(_mm_mul_ps(x, _mm_set1_ps(FOUR_OVER_PI)));
+		octant = _mm_add_epi32(octant, _mm_set1_epi32(1));
+		octant = _mm_and_si128(octant, _mm_set1_epi32(~1));
+		__m128 y = _mm_cvtepi32_ps(octant);
+
+		__m128 swapSignSin = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(octant, _mm_set1_epi32(4)), 29));
+		__m128 signCos = _mm_castsi128_ps(_mm_slli_epi32(_mm_andnot_si128(
+			_mm_sub_epi32(octant, _mm_set1_epi32(2)), _mm_set1_epi32(4)), 29));
+		__m128 polyMask = _mm_castsi128_ps(_mm_cmpeq_epi32(
+			_mm_and_si128(octant, _mm_set1_epi32(2)), _mm_setzero_si128()));
+		signSin = _mm_xor_ps(signSin, swapSignSin);
+
+		// subtract the octant in three parts to keep the precision
+		x = _mm_add_ps(x, _mm_mul_ps(y, _mm_set1_ps(DP1)));
+		x = _mm_add_ps(x, _mm_mul_ps(y, _mm_set1_ps(DP2)));
+		x = _mm_add_ps(x, _mm_mul_ps(y, _mm_set1_ps(DP3)));
+		__m128 z = _mm_mul_ps(x, x);
+
+		// cosine polynomial
+		__m128 yc = _mm_set1_ps(COS_P0);
+		yc = _mm_add_ps(_mm_mul_ps(yc, z), _mm_set1_ps(COS_P1));
+		yc = _mm_add_ps(_mm_mul_ps(yc, z), _mm_set1_ps(COS_P2));
+		yc = _mm_mul_ps(_mm_mul_ps(yc, z), z);
+		yc = _mm_sub_ps(yc, _mm_mul_ps(z, _mm_set1_ps(0.5f)));
+		yc = _mm_add_ps(yc, _mm_set1_ps(1.0f));
+
+		// sine polynomial
+		__m128 ys = _mm_set1_ps(SIN_P0);
+		ys = _mm_add_ps(_mm_mul_ps(ys, z), _mm_set1_ps(SIN_P1));
+		ys = _mm_add_ps(_mm_mul_ps(ys, z), _mm_set1_ps(SIN_P2));
+		ys = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(ys, z), x), x);
+
+		// pick which polynomial gives which result for each octant
+		__m128 sinResult = _mm_or_ps(_mm_and_ps(polyMask, ys), _mm_andnot_ps(polyMask, yc));
+		__m128 cosResult = _mm_or_ps(_mm_and_ps(polyMask, yc), _mm_andnot_ps(polyMask, ys));
+
+		s = _mm_xor_ps(sinResult, signSin);
+		c = _mm_xor_ps(cosResult, signCos);
+	}
+#endif
+
+#if defined(PHYSICS_SIMD_AVX2)
+	// works out the sine and cosine of 8 angles at once
+	inline void sincos8(__m256 x, __m256& s, __m256& c)
+	{
+		const __m256 signMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x80000000));
+
+		// work with the absolute value and put the sign back on the sine
+		__m256 signSin = _mm256_and_ps(x, signMask);
+		x = _mm256_andnot_ps(signMask, x);
+
+		// find which octant the angle is in, rounded up to an even one
+		__m256i octant = _mm256_cvttps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(FOUR_OVER_PI)));
+		octant = _mm256_add_epi32(octant, _mm256_set1_epi32(1));
+		octant = _mm256_and_si256(octant, _mm256_set1_epi32(~1));
+		__m256 y = _mm256_cvtepi32_ps(octant);
+
+		__m256 swapSignSin = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(octant, _mm256_set1_epi32(4)), 29));
+		__m256 signCos = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_andnot_si256(
+			_mm256_sub_epi32(octant, _mm256_set1_epi32(2)), _mm256_set1_epi32(4)), 29));
+		__m256 polyMask = _mm256_castsi256_ps(_mm256_cmpeq_epi32(
+			_mm256_and_si256(octant, _mm256_set1_epi32(2)), _mm256_setzero_si256()));
+		signSin = _mm256_xor_ps(signSin, swapSignSin);
+
+		// subtract the octant in three parts to keep the precision
+		x = _mm256_add_ps(x, _mm256_mul_ps(y, _mm256_set1_ps(DP1)));
+		x = _mm256_add_ps(x, _mm256_mul_ps(y, _mm256_set1_ps(DP2)));
+		x = _mm256_add_ps(x, _mm256_mul_ps(y, _mm256_set1_ps(DP3)));
+		__m256 z = _mm256_mul_ps(x, x);
+
+		// cosine polynomial
+		__m256 yc = _mm256_set1_ps(COS_P0);
+		yc = _mm256_add_ps(_mm256_mul_ps(yc, z), _mm256_set1_ps(COS_P1));
+		yc = _mm256_add_ps(_mm256_mul_ps(yc, z), _mm256_set1_ps(COS_P2));
+		yc = _mm256_mul_ps(_mm256_mul_ps(yc, z), z);
+		yc = _mm256_sub_ps(yc, _mm256_mul_ps(z, _mm256_set1_ps(0.5f)));
+		yc = _mm256_add_ps(yc, _mm256_set1_ps(1.0f));
+
+		// sine polynomial
+		__m256 ys = _mm256_set1_ps(SIN_P0);
+		ys = _mm256_add_ps(_mm256_mul_ps(ys, z), _mm256_set1_ps(SIN_P1));
+		ys = _mm256_add_ps(_mm256_mul_ps(ys, z), _mm256_set1_ps(SIN_P2));
+		ys = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(ys, z), x), x);
+
+		// pick which polynomial gives which result for each octant
+		__m256 sinResult = _mm256_blendv_ps(yc, ys, polyMask);
+		__m256 cosResult = _mm256_blendv_ps(ys, yc, polyMask);
+
+		s = _mm256_xor_ps(sinResult, signSin);
+		c = _mm256_xor_ps(cosResult, signCos);
+	}
+#endif
+}
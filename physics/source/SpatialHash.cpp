@@ -0,0 +1,234 @@
+#include "SpatialHash.h"
+#include <algorithm>
+#include <cmath>
+
+SpatialHash::SpatialHash(const float cellSize) : m_cellSize(cellSize)
+{
+
+}
+
+void SpatialHash::addActor(PhysicsObject* actor)
+{
+	int id;
+	if (!m_freeProxies.empty())
+	{
+		id = m_freeProxies.back();
+		m_freeProxies.pop_back();
+	}
+	else
+	{
+		id = (int)m_proxies.size();
+		m_proxies.push_back(Proxy());
+	}
+
+	Proxy& proxy = m_proxies[id];
+	proxy.actor = actor;
+	proxy.isSleeping = false;
+	actor->setBroadphaseId(id);
+}
+
+void SpatialHash::removeActor(PhysicsObject* actor)
+{
+	int id = actor->getBroadphaseId();
+	if (id < 0 || id >= (int)m_proxies.size() || m_proxies[id].actor != actor)
+	{
+		return;
+	}
+	actor->setBroadphaseId(-1);
+
+	// the sleeping entries still point at it until they're rebinned
+	if (m_proxies[id].isSleeping)
+	{
+		m_sleepingChanged = true;
+	}
+	m_proxies[id].actor = nullptr;
+	m_freeProxies.push_back(id);
+}
+
+void SpatialHash::updateProxy(Proxy& proxy, const glm::vec2 min, const glm::vec2 max)
+{
+	float invCellSize = 1.0f / m_cellSize;
+	float maxSpan = m_cellSize * m_maxCellsPerAxis;
+	glm::vec2 span = max - min;
+
+	proxy.min = min;
+	proxy.max = max;
+	proxy.isLarge = !(span.x <= maxSpan && span.y <= maxSpan);
+	if (proxy.isLarge)
+	{
+		return;
+	}
+
+	proxy.minX = (int)std::floor(min.x * invCellSize);
+	proxy.minY = (int)std::floor(min.y * invCellSize);
+	proxy.maxX = (int)std::floor(max.x * invCellSize);
+	proxy.maxY = (int)std::floor(max.y * invCellSize);
+}
+
+void SpatialHash::binProxy(const int id, std::vector<CellEntry>& entries) const
+{
+	const Proxy& proxy = m_proxies[id];
+	for (int x = proxy.minX; x <= proxy.maxX; x++)
+	{
+		for (int y = proxy.minY; y <= proxy.maxY; y++)
+		{
+			entries.push_back({ cellKey(x, y), id });
+		}
+	}
+}
+
+void SpatialHash::rebinSleeping()
+{
+	m_sleepingEntries.clear();
+	for (int id = 0; id < (int)m_proxies.size(); id++)
+	{
+		if (m_proxies[id].actor != nullptr && m_proxies[id].isSleeping)
+		{
+			binProxy(id, m_sleepingEntries);
+		}
+	}
+	std::sort(m_sleepingEntries.begin(), m_sleepingEntries.end());
+	m_sleepingChanged = false;
+}
+
+void SpatialHash::rebinAll()
+{
+	for (auto& proxy : m_proxies)
+	{
+		proxy.isSleeping = false;
+	}
+	m_sleepingEntries.clear();
+	m_sleepingChanged = false;
+}
+
+// the proxies already track every actor, so the list isn't needed
+void SpatialHash::findPairs(const std::vector<PhysicsObject*>&, std::vector<CollisionPair>& pairs)
+{
+	m_entries.clear();
+	m_largeProxies.clear();
+
+	// bin every awake actor into the cells its bounds touch. sleeping ones
+	// whose bounds haven't changed are already in the sleeping entries
+	int proxyCount = (int)m_proxies.size();
+	for (int id = 0; id < proxyCount; id++)
+	{
+		Proxy& proxy = m_proxies[id];
+		if (proxy.actor == nullptr)
+		{
+			continue;
+		}
+
+		glm::vec2 min, max;
+		proxy.actor->getBounds(min, max);
+		bool sleeping = proxy.actor->isSleeping();
+		if (sleeping && proxy.isSleeping && min == proxy.min && max == proxy.max)
+		{
+			continue;
+		}
+
+		updateProxy(proxy, min, max);
+		proxy.isInactive = !proxy.actor->isActive();
+
+		// large actors are tested against everything every step anyway
+		sleeping = sleeping && !proxy.isLarge;
+		if (sleeping || proxy.isSleeping)
+		{
+			m_sleepingChanged = true;
+		}
+		proxy.isSleeping = sleeping;
+
+		if (proxy.isLarge)
+		{
+			m_largeProxies.push_back(id);
+		}
+		else if (!sleeping)
+		{
+			binProxy(id, m_entries);
+		}
+	}
+
+	if (m_sleepingChanged)
+	{
+		rebinSleeping();
+	}
+
+	// sorting groups the actors in each cell together
+	std::sort(m_entries.begin(), m_entries.end());
+
+	// sleeping actors can't collide with each other, so only the cells
+	// with an awake actor in them matter
+	int entryCount = (int)m_entries.size();
+	auto sleepingBegin = m_sleepingEntries.begin();
+	for (int start = 0; start < entryCount;)
+	{
+		uint64_t key = m_entries[start].key;
+		int end = start + 1;
+		while (end < entryCount && m_entries[end].key == key)
+		{
+			end++;
+		}
+
+		sleepingBegin = std::lower_bound(sleepingBegin, m_sleepingEntries.end(), CellEntry{ key, -1 });
+		auto sleepingEnd = sleepingBegin;
+		while (sleepingEnd != m_sleepingEntries.end() && sleepingEnd->key == key)
+		{
+			sleepingEnd++;
+		}
+
+		int cellX = (int)(uint32_t)(key >> 32);
+		int cellY = (int)(uint32_t)(key);
+
+		for (int outer = start; outer < end; outer++)
+		{
+			int i = m_entries[outer].proxy;
+			const Proxy& a = m_proxies[i];
+
+			for (int inner = outer + 1; inner < end; inner++)
+			{
+				const Proxy& b = m_proxies[m_entries[inner].proxy];
+				if ((a.isInactive && b.isInactive) || !isFirstCell(a, b, cellX, cellY) || !overlaps(a, b))
+				{
+					continue;
+				}
+				pairs.push_back({ a.actor, b.actor });
+			}
+
+			// static actors that are awake don't need the sleeping ones
+			if (a.isInactive)
+			{
+				continue;
+			}
+			for (auto sleeping = sleepingBegin; sleeping != sleepingEnd; ++sleeping)
+			{
+				int j = sleeping->proxy;
+				const Proxy& b = m_proxies[j];
+				if (!isFirstCell(a, b, cellX, cellY) || !overlaps(a, b))
+				{
+					continue;
+				}
+				pairs.push_back({ m_proxies[std::min(i, j)].actor, m_proxies[std::max(i, j)].actor });
+			}
+		}
+
+		start = end;
+		sleepingBegin = sleepingEnd;
+	}
+
+	// large actors can't be binned so test them against everything
+	for (int i : m_largeProxies)
+	{
+		const Proxy& a = m_proxies[i];
+		for (int j = 0; j < proxyCount; j++)
+		{
+			const Proxy& b = m_proxies[j];
+
+			// avoid reporting pairs of large actors twice
+			if (b.actor == nullptr || j == i || (b.isLarge && j < i) || (a.isInactive && b.isInactive) || !overlaps(a, b))
+			{
+				continue;
+			}
+
+			pairs.push_back({ m_proxies[std::min(i, j)].actor, m_proxies[std::max(i, j)].actor });
+		}
+	}
+}
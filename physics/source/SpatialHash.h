@@ -0,0 +1,101 @@
+#pragma once
+#include "Broadphase.h"
+#include <glm/vec2.hpp>
+#include <cstdint>
+#include <algorithm>
+
+// uniform grid broadphase
+// every actor is binned into each cell its world bounds touch, and only
+// actors that share a cell are handed on as pairs.
+// actors with unbounded (planes) or very large bounds are kept aside and
+// paired with everything.
+// sleeping actors are binned once when they fall asleep and kept in their
+// own sorted list until one of them wakes, moves or is removed, so a
+// scene that is mostly asleep only bins what's awake each step
+class SpatialHash : public Broadphase
+{
+public:
+	SpatialHash(const float cellSize = 50.0f);
+	virtual ~SpatialHash() {};
+
+	virtual void addActor(PhysicsObject* actor);
+	virtual void removeActor(PhysicsObject* actor);
+
+	virtual void findPairs(const std::vector<PhysicsObject*>& actors, std::vector<CollisionPair>& pairs);
+
+	void setCellSize(const float cellSize) { m_cellSize = cellSize; rebinAll(); }
+	float getCellSize() const { return m_cellSize; }
+
+	// actors spanning more than this many cells on either axis are treated as large
+	void setMaxCellsPerAxis(const int maxCells) { m_maxCellsPerAxis = maxCells; rebinAll(); }
+	int getMaxCellsPerAxis() const { return m_maxCellsPerAxis; }
+
+protected:
+
+	// one entry per (cell, proxy) overlap
+	struct CellEntry
+	{
+		uint64_t key;
+		int proxy;
+
+		bool operator<(const CellEntry& other) const
+		{
+			return key < other.key || (key == other.key && proxy < other.proxy);
+		}
+	};
+
+	// an actor's bounds and the range of cells they cover
+	struct Proxy
+	{
+		PhysicsObject* actor;
+		glm::vec2 min;
+		glm::vec2 max;
+
+		int minX, minY;
+		int maxX, maxY;
+		bool isLarge;
+		bool isInactive;
+
+		// binned into m_sleepingEntries rather than m_entries
+		bool isSleeping;
+	};
+
+	static uint64_t cellKey(const int x, const int y)
+	{
+		return ((uint64_t)(uint32_t)x << 32) | (uint64_t)(uint32_t)y;
+	}
+
+	bool overlaps(const Proxy& a, const Proxy& b) const
+	{
+		return !(a.max.x < b.min.x || a.min.x > b.max.x || a.max.y < b.min.y || a.min.y > b.max.y);
+	}
+
+	// a pair sharing several cells is only reported from the first cell of
+	// their overlap
+	bool isFirstCell(const Proxy& a, const Proxy& b, const int cellX, const int cellY) const
+	{
+		return std::max(a.minX, b.minX) == cellX && std::max(a.minY, b.minY) == cellY;
+	}
+
+	void updateProxy(Proxy& proxy, const glm::vec2 min, const glm::vec2 max);
+	void binProxy(const int id, std::vector<CellEntry>& entries) const;
+	void rebinSleeping();
+
+	// the cells have changed shape, so the sleeping actors are binned again
+	// along with the awake ones
+	void rebinAll();
+
+	float m_cellSize;
+	int m_maxCellsPerAxis = 16;
+
+	std::vector<Proxy> m_proxies;
+	std::vector<int> m_freeProxies;
+
+	// kept between calls so that steady state binning doesn't allocate
+	std::vector<CellEntry> m_entries;
+	std::vector<CellEntry> m_sleepingEntries;
+	std::vector<int> m_largeProxies;
+
+	// a sleeping actor woke, moved or went, or another fell asleep
+	bool m_sleepingChanged = false;
+};
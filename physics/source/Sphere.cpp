@@ -0,0 +1,28 @@
+#include "Sphere.h"
+#include <glm/ext.hpp>
+#include <string>
+#include <math.h>
+
+Sphere::Sphere() :
+RigidBody(ShapeTypes::SPHERE)
+{
+	
+}
+
+Sphere::~Sphere()
+{
+
+}
+
+void Sphere::calculateBounds()
+{
+	glm::vec2 position = getPosition();
+	m_boundsMin = position - glm::vec2(m_radius);
+	m_boundsMax = position + glm::vec2(m_radius);
+}
+
+// calculate moment of inertia
+void Sphere::calculateMoment()
+{
+	setMoment(0.5f * m_mass * m_radius * m_radius);
+}
@@ -1,8 +1,6 @@
 #pragma once
 #include "RigidBody.h"
-#include <glm\vec4.hpp>
-
-#include "Renderer2D.h"
+#include <glm/vec4.hpp>
 
 class Sphere : public RigidBody
 {
@@ -10,7 +8,7 @@ public:
 	Sphere();
 
 	~Sphere();
-	virtual void draw();
+	virtual void calculateBounds();
 
 	float getRadius() const { return m_radius; }
 
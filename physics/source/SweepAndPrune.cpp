@@ -0,0 +1,261 @@
+#include "SweepAndPrune.h"
+#include <algorithm>
+
+void SweepAndPrune::addActor(PhysicsObject* actor)
+{
+	int id;
+	if (!m_freeProxies.empty())
+	{
+		id = m_freeProxies.back();
+		m_freeProxies.pop_back();
+	}
+	else
+	{
+		id = (int)m_proxies.size();
+		m_proxies.push_back(Proxy());
+	}
+
+	Proxy& proxy = m_proxies[id];
+	proxy.actor = actor;
+	proxy.added = true;
+	actor->setBroadphaseId(id);
+
+	// its endpoints are sorted in with everything else added this step
+	m_added.push_back(id);
+}
+
+void SweepAndPrune::removeActor(PhysicsObject* actor)
+{
+	int id = actor->getBroadphaseId();
+	if (id < 0 || id >= (int)m_proxies.size() || m_proxies[id].actor != actor)
+	{
+		return;
+	}
+	actor->setBroadphaseId(-1);
+
+	// the proxy isn't reused until its endpoints and pairs are gone
+	m_proxies[id].actor = nullptr;
+	m_removed.push_back(id);
+}
+
+// the proxies already track every actor, so the list isn't needed
+void SweepAndPrune::findPairs(const std::vector<PhysicsObject*>&, std::vector<CollisionPair>& pairs)
+{
+	removePending();
+
+	// refresh the bounds of every proxy. sleeping actors' bounds aren't
+	// worked out so theirs can't have changed, they're picked up on waking
+	for (auto& proxy : m_proxies)
+	{
+		if (proxy.actor != nullptr && (proxy.added || !proxy.actor->isSleeping()))
+		{
+			proxy.actor->getBounds(proxy.min, proxy.max);
+		}
+	}
+
+	// the added endpoints go in after the sort so none of their swaps are
+	// recorded, a new actor has no history so its pairs are found directly
+	sortAxis(0);
+	sortAxis(1);
+	if (!m_added.empty())
+	{
+		addPending();
+		findAddedPairs();
+	}
+	commitChanges();
+
+	for (auto key : m_pairKeys)
+	{
+		PhysicsObject* a = m_proxies[(int)(key >> 32)].actor;
+		PhysicsObject* b = m_proxies[(int)(key & 0xffffffff)].actor;
+		if (canCollide(a, b))
+		{
+			pairs.push_back({ a, b });
+		}
+	}
+}
+
+void SweepAndPrune::removePending()
+{
+	if (m_removed.empty())
+	{
+		return;
+	}
+
+	// one pass over the endpoints and pairs however many were removed.
+	// proxies removed before their endpoints went in have none
+	auto removed = [this](const int id) { return m_proxies[id].actor == nullptr; };
+	for (int axis = 0; axis < 2; axis++)
+	{
+		std::vector<Endpoint>& endpoints = m_endpoints[axis];
+		endpoints.erase(std::remove_if(endpoints.begin(), endpoints.end(),
+			[&](const Endpoint& e) { return removed(e.proxy); }), endpoints.end());
+	}
+
+	m_pairKeys.erase(std::remove_if(m_pairKeys.begin(), m_pairKeys.end(),
+		[&](const uint64_t key) { return removed((int)(key >> 32)) || removed((int)(key & 0xffffffff)); }), m_pairKeys.end());
+
+	for (int id : m_removed)
+	{
+		m_proxies[id].added = false;
+		m_freeProxies.push_back(id);
+	}
+	m_removed.clear();
+}
+
+void SweepAndPrune::addPending()
+{
+	for (int axis = 0; axis < 2; axis++)
+	{
+		// sort the new endpoints on their own and merge them in
+		m_addedEndpoints.clear();
+		for (int id : m_added)
+		{
+			const Proxy& proxy = m_proxies[id];
+			if (proxy.actor != nullptr)
+			{
+				m_addedEndpoints.push_back({ proxy.min[axis], id, true });
+				m_addedEndpoints.push_back({ proxy.max[axis], id, false });
+			}
+		}
+		std::sort(m_addedEndpoints.begin(), m_addedEndpoints.end());
+
+		std::vector<Endpoint>& endpoints = m_endpoints[axis];
+		m_mergedEndpoints.resize(endpoints.size() + m_addedEndpoints.size());
+		std::merge(endpoints.begin(), endpoints.end(), m_addedEndpoints.begin(), m_addedEndpoints.end(),
+			m_mergedEndpoints.begin());
+		endpoints.swap(m_mergedEndpoints);
+	}
+}
+
+// sweeps the x axis keeping the proxies that are open at each point. an
+// added proxy pairs with everything open, the others only with the added
+// ones, so only pairs with an added actor are tested
+void SweepAndPrune::findAddedPairs()
+{
+	m_open.clear();
+	m_openAdded.clear();
+
+	for (auto& endpoint : m_endpoints[0])
+	{
+		int id = endpoint.proxy;
+		bool added = m_proxies[id].added;
+		std::vector<int>& open = added ? m_openAdded : m_open;
+
+		if (!endpoint.isMin)
+		{
+			int last = open.back();
+			open[m_proxies[id].open] = last;
+			m_proxies[last].open = m_proxies[id].open;
+			open.pop_back();
+			continue;
+		}
+
+		for (int other : m_openAdded)
+		{
+			if (overlaps(id, other))
+			{
+				m_changedKeys.push_back(pairKey(id, other));
+			}
+		}
+		if (added)
+		{
+			for (int other : m_open)
+			{
+				if (overlaps(id, other))
+				{
+					m_changedKeys.push_back(pairKey(id, other));
+				}
+			}
+		}
+		m_proxies[id].open = (int)open.size();
+		open.push_back(id);
+	}
+
+	for (int id : m_added)
+	{
+		m_proxies[id].added = false;
+	}
+	m_added.clear();
+}
+
+bool SweepAndPrune::overlaps(const int a, const int b) const
+{
+	const Proxy& p1 = m_proxies[a];
+	const Proxy& p2 = m_proxies[b];
+
+	return !(p1.max.x < p2.min.x || p1.min.x > p2.max.x ||
+		p1.max.y < p2.min.y || p1.min.y > p2.max.y);
+}
+
+// insertion sort the endpoints along one axis, recording every pair whose
+// endpoints swap past each other
+void SweepAndPrune::sortAxis(const int axis)
+{
+	std::vector<Endpoint>& endpoints = m_endpoints[axis];
+	int count = (int)endpoints.size();
+
+	for (auto& endpoint : endpoints)
+	{
+		const Proxy& proxy = m_proxies[endpoint.proxy];
+		endpoint.value = endpoint.isMin ? proxy.min[axis] : proxy.max[axis];
+	}
+
+	for (int i = 1; i < count; i++)
+	{
+		Endpoint key = endpoints[i];
+		int j = i - 1;
+
+		while (j >= 0 && key < endpoints[j])
+		{
+			// a min passing a max (or a max passing a min) is the only time
+			// two actors can start or stop overlapping on this axis
+			if (key.isMin != endpoints[j].isMin)
+			{
+				m_changedKeys.push_back(pairKey(key.proxy, endpoints[j].proxy));
+			}
+
+			endpoints[j + 1] = endpoints[j];
+			j--;
+		}
+		endpoints[j + 1] = key;
+	}
+}
+
+// merge the changed pairs into the persistent pair list
+void SweepAndPrune::commitChanges()
+{
+	if (m_changedKeys.empty())
+	{
+		return;
+	}
+
+	std::sort(m_changedKeys.begin(), m_changedKeys.end());
+	m_changedKeys.erase(std::unique(m_changedKeys.begin(), m_changedKeys.end()), m_changedKeys.end());
+
+	m_scratchKeys.clear();
+
+	auto existing = m_pairKeys.begin();
+	for (auto key : m_changedKeys)
+	{
+		// keep the untouched pairs before this one
+		while (existing != m_pairKeys.end() && *existing < key)
+		{
+			m_scratchKeys.push_back(*existing++);
+		}
+		if (existing != m_pairKeys.end() && *existing == key)
+		{
+			existing++;
+		}
+
+		// a swapped pair stays in the list only if it really overlaps now
+		if (overlaps((int)(key >> 32), (int)(key & 0xffffffff)))
+		{
+			m_scratchKeys.push_back(key);
+		}
+	}
+	m_scratchKeys.insert(m_scratchKeys.end(), existing, m_pairKeys.end());
+
+	m_pairKeys.swap(m_scratchKeys);
+	m_changedKeys.clear();
+}
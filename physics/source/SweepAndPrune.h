@@ -0,0 +1,93 @@
+#pragma once
+#include "Broadphase.h"
+#include <glm/vec2.hpp>
+#include <cstdint>
+
+// incremental sweep and prune broadphase
+// keeps the min/max bounds of every actor sorted along both axes between
+// steps and re-sorts them with an insertion sort. because bodies only move
+// a little each step very few endpoints swap, and only those swaps can
+// change the set of overlapping pairs, which is kept between steps too.
+// adding and removing actors is batched up until the next findPairs, so
+// building a scene doesn't re-sort the endpoints for every actor
+class SweepAndPrune : public Broadphase
+{
+public:
+	SweepAndPrune() {};
+	virtual ~SweepAndPrune() {};
+
+	virtual void addActor(PhysicsObject* actor);
+	virtual void removeActor(PhysicsObject* actor);
+
+	virtual void findPairs(const std::vector<PhysicsObject*>& actors, std::vector<CollisionPair>& pairs);
+
+	int getPairCount() const { return (int)m_pairKeys.size(); }
+
+protected:
+
+	struct Proxy
+	{
+		PhysicsObject* actor;
+		glm::vec2 min;
+		glm::vec2 max;
+
+		// added since the last findPairs, so its endpoints aren't sorted in yet
+		bool added;
+
+		// where it is in the open list while sweeping for added pairs
+		int open;
+	};
+
+	struct Endpoint
+	{
+		float value;
+		int proxy;
+		bool isMin;
+
+		// mins sort ahead of maxes at the same value so touching bounds count as overlapping
+		bool operator<(const Endpoint& other) const
+		{
+			return value < other.value || (value == other.value && isMin && !other.isMin);
+		}
+	};
+
+	static uint64_t pairKey(const int a, const int b)
+	{
+		return a < b ? ((uint64_t)a << 32) | (uint64_t)b : ((uint64_t)b << 32) | (uint64_t)a;
+	}
+
+	bool overlaps(const int a, const int b) const;
+	void sortAxis(const int axis);
+	void commitChanges();
+
+	// drops the endpoints and pairs of the actors removed since the last
+	// findPairs, and merges in the endpoints of the ones added
+	void removePending();
+	void addPending();
+
+	// finds every overlapping pair with an added actor in one sweep
+	void findAddedPairs();
+
+	std::vector<Proxy> m_proxies;
+	std::vector<int> m_freeProxies;
+
+	// proxies added or removed since the last findPairs
+	std::vector<int> m_added;
+	std::vector<int> m_removed;
+
+	// sorted endpoint lists, one for each axis
+	std::vector<Endpoint> m_endpoints[2];
+
+	// sorted keys of every overlapping pair
+	std::vector<uint64_t> m_pairKeys;
+
+	// pairs that may have started or stopped overlapping this step
+	std::vector<uint64_t> m_changedKeys;
+	std::vector<uint64_t> m_scratchKeys;
+
+	// scratch for merging in added endpoints and sweeping for their pairs
+	std::vector<Endpoint> m_addedEndpoints;
+	std::vector<Endpoint> m_mergedEndpoints;
+	std::vector<int> m_open;
+	std::vector<int> m_openAdded;
+};
@@ -0,0 +1,160 @@
+#include "ThreadPool.h"
+#include "Profiler.h"
+
+ThreadPool::ThreadPool(const int threadCount) :
+	m_queues(threadCount > 1 ? threadCount : 1)
+{
+	m_remaining = 0;
+	m_workerAllocations = 0;
+
+	// queue 0 belongs to the calling thread
+	for (int i = 1; i < (int)m_queues.size(); i++)
+	{
+		m_workers.emplace_back(&ThreadPool::workerMain, this, i);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_wakeMutex);
+		m_quit = true;
+	}
+	m_wakeCondition.notify_all();
+
+	for (auto& worker : m_workers)
+	{
+		worker.join();
+	}
+}
+
+void ThreadPool::parallelFor(const int count, JobFunction function, void* data)
+{
+	if (count <= 0)
+	{
+		return;
+	}
+
+	// nothing to share the work with
+	if (m_workers.empty() || count == 1)
+	{
+		for (int i = 0; i < count; i++)
+		{
+			function(data, i);
+		}
+		return;
+	}
+
+	m_function = function;
+	m_data = data;
+	m_remaining = count;
+
+	// deal the jobs out like cards so every thread starts on one of the
+	// first (biggest) jobs
+	int threadCount = getThreadCount();
+	for (int i = 0; i < threadCount; i++)
+	{
+		Queue& queue = m_queues[i];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+
+		queue.head = 0;
+		queue.tail = (count - i + threadCount - 1) / threadCount;
+	}
+
+	{
+		// a worker still waking from the last batch reads the tag, so it
+		// changes under the same lock
+		std::lock_guard<std::mutex> lock(m_wakeMutex);
+		m_tag = AllocationCounter::getTag();
+		m_generation++;
+	}
+	m_wakeCondition.notify_all();
+
+	runJobs(0);
+
+	// wait for the jobs other threads are still running
+	std::unique_lock<std::mutex> lock(m_doneMutex);
+	m_doneCondition.wait(lock, [this]() { return m_remaining.load() == 0; });
+}
+
+void ThreadPool::workerMain(const int index)
+{
+	unsigned int generation = 0;
+	AllocationCounter::Tag tag = AllocationCounter::OTHER;
+
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_wakeMutex);
+			m_wakeCondition.wait(lock, [&]() { return m_quit || m_generation != generation; });
+
+			if (m_quit)
+			{
+				return;
+			}
+			generation = m_generation;
+			tag = m_tag;
+		}
+
+		AllocationCounter::ScopedTag scopedTag(tag);
+		runJobs(index);
+	}
+}
+
+void ThreadPool::runJobs(const int index)
+{
+	PROFILE_ZONE("ThreadPool::runJobs");
+
+	int job;
+	while (popJob(index, job) || stealJob(index, job))
+	{
+		size_t allocations = AllocationCounter::getThreadCount();
+		m_function(m_data, job);
+
+		// added before the job counts as done so the caller sees it
+		if (index != 0 && AllocationCounter::getThreadCount() != allocations)
+		{
+			m_workerAllocations += AllocationCounter::getThreadCount() - allocations;
+		}
+
+		if (--m_remaining == 0)
+		{
+			std::lock_guard<std::mutex> lock(m_doneMutex);
+			m_doneCondition.notify_all();
+		}
+	}
+}
+
+// the owner takes jobs from the front of its queue, in order
+bool ThreadPool::popJob(const int index, int& job)
+{
+	Queue& queue = m_queues[index];
+	std::lock_guard<std::mutex> lock(queue.mutex);
+
+	if (queue.head == queue.tail)
+	{
+		return false;
+	}
+	job = index + queue.head++ * getThreadCount();
+	return true;
+}
+
+// thieves take the smallest jobs from the back, which keeps them away from
+// the owner
+bool ThreadPool::stealJob(const int index, int& job)
+{
+	int threadCount = getThreadCount();
+	for (int i = 1; i < threadCount; i++)
+	{
+		int victim = (index + i) % threadCount;
+		Queue& queue = m_queues[victim];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+
+		if (queue.head != queue.tail)
+		{
+			job = victim + --queue.tail * threadCount;
+			return true;
+		}
+	}
+	return false;
+}
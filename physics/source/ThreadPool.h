@@ -0,0 +1,77 @@
+#pragma once
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include "AllocationCounter.h"
+
+// a small work stealing thread pool
+// parallelFor deals job indices out to a queue per thread, each thread works
+// through its own queue and then steals from the others when it runs dry.
+// jobs are started roughly in index order, so put the biggest ones first.
+// jobs are a function pointer and a void pointer so nothing gets allocated
+// per job
+class ThreadPool
+{
+public:
+	typedef void(*JobFunction)(void* data, int index);
+
+	// threadCount includes the thread calling parallelFor, so 1 means no
+	// workers and everything runs inline
+	ThreadPool(const int threadCount);
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	int getThreadCount() const { return (int)m_queues.size(); }
+
+	// how many allocations the workers have made running jobs so far. the
+	// caller's own are in its AllocationCounter::getThreadCount
+	size_t getWorkerAllocations() const { return m_workerAllocations.load(); }
+
+	// runs function(data, i) for every i in [0, count) and waits for them
+	// all to finish. the calling thread helps out
+	void parallelFor(const int count, JobFunction function, void* data);
+
+private:
+
+	// queue i holds the jobs i, i + threadCount, i + 2 * threadCount and so
+	// on, so it only needs to know which run of those is left
+	struct Queue
+	{
+		std::mutex mutex;
+		int head = 0;
+		int tail = 0;
+	};
+
+	void workerMain(const int index);
+
+	// runs jobs from the thread's own queue and then steals from the rest
+	// until there's nothing left
+	void runJobs(const int index);
+	bool popJob(const int index, int& job);
+	bool stealJob(const int index, int& job);
+
+	std::vector<std::thread> m_workers;
+	std::vector<Queue> m_queues;
+
+	JobFunction m_function = nullptr;
+	void* m_data = nullptr;
+
+	// the workers charge their allocations to whatever the caller was
+	AllocationCounter::Tag m_tag = AllocationCounter::OTHER;
+	std::atomic<size_t> m_workerAllocations;
+
+	// the workers sleep until the generation changes
+	std::mutex m_wakeMutex;
+	std::condition_variable m_wakeCondition;
+	unsigned int m_generation = 0;
+	bool m_quit = false;
+
+	// the caller sleeps until this reaches 0
+	std::atomic<int> m_remaining;
+	std::mutex m_doneMutex;
+	std::condition_variable m_doneCondition;
+};
@@ -0,0 +1,54 @@
+#pragma once
+#include <atomic>
+
+// hands values from one writer thread to one reader thread without either
+// waiting on the other. the writer fills the back slot and publishes it,
+// the reader picks up the newest published slot whenever it likes. the
+// third slot is the one in between, so neither side ever touches the slot
+// the other is using, and a reader that falls behind just skips values
+template <typename T>
+class TripleBuffer
+{
+public:
+	TripleBuffer() {};
+	~TripleBuffer() {};
+
+	TripleBuffer(const TripleBuffer&) = delete;
+	TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+	// writer only. the slot to fill, it holds whatever was in it last time
+	T& getBack() { return m_slots[m_back]; }
+
+	// writer only. makes the back slot the newest value and takes the
+	// middle one to write into next
+	void publish()
+	{
+		m_back = m_middle.exchange(m_back | PUBLISHED, std::memory_order_acq_rel) & INDEX_MASK;
+	}
+
+	// reader only. swaps in the newest value if there's one the reader
+	// hasn't seen, returns false if there isn't
+	bool acquire()
+	{
+		if ((m_middle.load(std::memory_order_relaxed) & PUBLISHED) == 0)
+		{
+			return false;
+		}
+		m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & INDEX_MASK;
+		return true;
+	}
+
+	// reader only. the value acquire last swapped in
+	const T& getFront() const { return m_slots[m_front]; }
+
+private:
+	// the middle slot's index, with a bit set while it holds a value the
+	// reader hasn't picked up
+	static constexpr int INDEX_MASK = 3;
+	static constexpr int PUBLISHED = 4;
+
+	T m_slots[3];
+	int m_back = 0;
+	std::atomic<int> m_middle{ 1 };
+	int m_front = 2;
+};
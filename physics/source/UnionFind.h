@@ -0,0 +1,63 @@
+#pragma once
+#include <vector>
+
+// disjoint sets over the integers [0, count), used to group bodies that
+// touch into islands
+class UnionFind
+{
+public:
+	UnionFind() {};
+	~UnionFind() {};
+
+	// puts every element back in a set of its own
+	void reset(const int count)
+	{
+		m_parents.resize(count);
+		m_ranks.assign(count, 0);
+		for (int i = 0; i < count; i++)
+		{
+			m_parents[i] = i;
+		}
+	}
+
+	// the representative of the set i is in
+	int find(int i)
+	{
+		while (m_parents[i] != i)
+		{
+			// halve the path as we go
+			m_parents[i] = m_parents[m_parents[i]];
+			i = m_parents[i];
+		}
+		return i;
+	}
+
+	// merges the sets a and b are in
+	void join(const int a, const int b)
+	{
+		int rootA = find(a);
+		int rootB = find(b);
+		if (rootA == rootB)
+		{
+			return;
+		}
+
+		if (m_ranks[rootA] < m_ranks[rootB])
+		{
+			m_parents[rootA] = rootB;
+		}
+		else if (m_ranks[rootA] > m_ranks[rootB])
+		{
+			m_parents[rootB] = rootA;
+		}
+		else
+		{
+			m_parents[rootB] = rootA;
+			m_ranks[rootA]++;
+		}
+	}
+
+private:
+	std::vector<int> m_parents;
+	std::vector<int> m_ranks;
+};